@@ -36,6 +36,9 @@
 #endif
 
 #include "yabmpconvert.h"
+#if defined(YABMP_HAVE_PREAD)
+#	include <unistd.h>
+#endif
 #include "../common/yabmp_printinfo.h"
 
 
@@ -109,6 +112,69 @@ static yabmp_status yabmp_file_seek(void* context, yabmp_uint32 offset)
 	return l_status;
 }
 
+/* FILE based positional read, only safe for concurrent calls when pread is available */
+static size_t yabmp_file_read_at (void* context, yabmp_uint32 offset, void * ptr, size_t size)
+{
+	FILE* l_file = (FILE*)context;
+#if defined(YABMP_HAVE_PREAD)
+	size_t l_read = 0U;
+#endif
+	
+	assert(l_file != NULL);
+	
+#if defined(YABMP_HAVE_PREAD)
+	/* the file is only read here, its stream buffer isn't used */
+	while (l_read < size) {
+		ssize_t l_result = pread(fileno(l_file), (char*)ptr + l_read, size - l_read, (off_t)offset + (off_t)l_read);
+		
+		if (l_result <= 0) {
+			break;
+		}
+		l_read += (size_t)l_result;
+	}
+	return l_read;
+#else
+	if (yabmp_file_seek(context, offset) != YABMP_OK) {
+		return 0U;
+	}
+	return fread(ptr, 1U, size, l_file);
+#endif
+}
+
+static void yabmp_file_close(void* context)
+{
+	FILE* l_file = (FILE*)context;
+	
+	assert(l_file != NULL);
+	fclose(l_file);
+}
+
+/* arena size for input, with room for ICC profile, read-ahead buffer & decoding threads */
+static size_t get_arena_size(const char* path, const void* data, size_t data_size)
+{
+	yabmp_uint8 l_prefix[64];
+	yabmp_probe_result l_probe;
+	size_t l_size = 0U;
+	
+	if (data == NULL) {
+		FILE* l_file = fopen(path, "rb");
+		if (l_file != NULL) {
+			data_size = fread(l_prefix, 1U, sizeof(l_prefix), l_file);
+			fclose(l_file);
+			data = l_prefix;
+		}
+	}
+	if ((data != NULL) && (yabmp_probe(data, data_size, &l_probe) == YABMP_OK) && (l_probe.missing_bytes == 0U)) {
+		if (yabmp_query_memory_requirements(&l_probe, YABMP_MEMORY_ROW_INDEX | YABMP_MEMORY_SCALE, &l_size) != YABMP_OK) {
+			return 0U;
+		}
+		/* 4 decoding threads use one row each */
+		l_size += 4U * (((size_t)l_probe.width * l_probe.bpp + 7U) / 8U * 2U + 64U);
+	}
+	/* invalid files still need a reader to report errors */
+	return l_size + 65536U;
+}
+
 static const char* get_appname(const char* app)
 {
 	const char* l_firstResult = NULL;
@@ -138,11 +204,14 @@ static void print_usage(FILE* stream, const char* app)
 		"usage:\n"
 		"%s -h|--help : this help message\n"
 		"%s -v|--version : print version\n"
-		"%s [-ekvq] [--no-seek] -i input -o output\n"
+		"%s [-ekafvq] [-g bt601|bt709] [--no-seek] -i input -o output\n"
 		"  -i, --input:           input filename\n"
 		"  -o, --output:          output filename\n"
 		"  -e, --expand-palette:  expand palette to RGB\n"
 		"  -k, --keep-palette:    keep grayscale palette\n"
+		"  -a, --expand-alpha:    expand to RGBA, adding opaque alpha when needed\n"
+		"  -f, --alpha-first:     read alpha before color samples, swapped back when writing\n"
+		"  -g, --rgb-to-gray:     convert colors to gray using bt601 or bt709 luma weights\n"
 		"  -n, --no-seek:         no seek function when reading from stdin\n"
 		"  -v, --version:         print version before info\n"
 		"  -q, --quiet:           no error/warning printed\n"
@@ -171,6 +240,9 @@ int main(int argc, char* argv[])
 		{ "output",         'o', OPTPARSE_REQUIRED },
 		{ "expand-palette", 'e', OPTPARSE_NONE },
 		{ "keep-palette",   'k', OPTPARSE_NONE },
+		{ "expand-alpha",   'a', OPTPARSE_NONE },
+		{ "alpha-first",    'f', OPTPARSE_NONE },
+		{ "rgb-to-gray",    'g', OPTPARSE_REQUIRED },
 		{ "no-seek",        'n', OPTPARSE_NONE },
 		{ "version",        'v', OPTPARSE_NONE },
 		{ "help",           'h', OPTPARSE_NONE },
@@ -179,6 +251,13 @@ int main(int argc, char* argv[])
 	};
 	const char* use_custom_malloc = NULL;
 	const char* use_memory_stream = NULL;
+	const char* use_read_buffer = NULL;
+	const char* use_mmap = NULL;
+	const char* use_threads = NULL;
+	const char* use_positional = NULL;
+	const char* use_arena = NULL;
+	const char* use_push = NULL;
+	const char* use_region = NULL;
 	int result = EXIT_SUCCESS;
 	yabmpconvert_parameters parameters;
 	struct optparse optparse;
@@ -201,6 +280,48 @@ int main(int argc, char* argv[])
 			use_memory_stream = NULL;
 		}
 	}
+	use_read_buffer = getenv("YABMP_USE_READ_BUFFER");
+	if (use_read_buffer != NULL) {
+		if ((use_read_buffer[0] == '0') && (use_read_buffer[1] == '\0')) {
+			use_read_buffer = NULL;
+		}
+	}
+	use_mmap = getenv("YABMP_USE_MMAP");
+	if (use_mmap != NULL) {
+		if ((use_mmap[0] == '0') && (use_mmap[1] == '\0')) {
+			use_mmap = NULL;
+		}
+	}
+	use_threads = getenv("YABMP_USE_THREADS");
+	if (use_threads != NULL) {
+		if ((use_threads[0] == '0') && (use_threads[1] == '\0')) {
+			use_threads = NULL;
+		}
+	}
+	use_arena = getenv("YABMP_USE_ARENA");
+	if (use_arena != NULL) {
+		if ((use_arena[0] == '0') && (use_arena[1] == '\0')) {
+			use_arena = NULL;
+		}
+	}
+	use_positional = getenv("YABMP_USE_POSITIONAL");
+	if (use_positional != NULL) {
+		if ((use_positional[0] == '0') && (use_positional[1] == '\0')) {
+			use_positional = NULL;
+		}
+	}
+	use_push = getenv("YABMP_USE_PUSH");
+	if (use_push != NULL) {
+		if ((use_push[0] == '0') && (use_push[1] == '\0')) {
+			use_push = NULL;
+		}
+	}
+	use_region = getenv("YABMP_USE_REGION");
+	if (use_region != NULL) {
+		if ((use_region[0] == '0') && (use_region[1] == '\0')) {
+			use_region = NULL;
+		}
+	}
 	
 	memset(&parameters, 0, sizeof(parameters));
 	if (use_custom_malloc != NULL) {
@@ -223,6 +344,25 @@ int main(int argc, char* argv[])
 			case 'k':
 				parameters.keep_gray_palette = 1;
 				break;
+			case 'a':
+				parameters.expand_alpha = 1;
+				break;
+			case 'f':
+				parameters.alpha_first = 1;
+				break;
+			case 'g':
+				parameters.rgb_to_gray = 1;
+				if (strcmp(optparse.optarg, "bt601") == 0) {
+					parameters.luma_weights = YABMP_LUMA_BT601;
+				} else if (strcmp(optparse.optarg, "bt709") == 0) {
+					parameters.luma_weights = YABMP_LUMA_BT709;
+				} else {
+					fprintf(stderr, "%s: invalid luma weights '%s'\n", argv[0], optparse.optarg);
+					print_usage(stderr, argv[0]);
+					result = 1;
+					goto BADEND;
+				}
+				break;
 			case 'v':
 				parameters.version = 1;
 				break;
@@ -276,11 +416,42 @@ int main(int argc, char* argv[])
 	if ((use_memory_stream != NULL) && !parameters.quiet) {
 		fprintf(stderr, "Using memory stream\n");
 	}
+	if ((use_read_buffer != NULL) && !parameters.quiet) {
+		fprintf(stderr, "Using read-ahead buffer\n");
+	}
+	if ((use_mmap != NULL) && !parameters.quiet) {
+		fprintf(stderr, "Using mapped file\n");
+	}
+	if ((use_arena != NULL) && !parameters.quiet) {
+		fprintf(stderr, "Using arena allocation\n");
+	}
+	if ((use_positional != NULL) && !parameters.quiet) {
+		fprintf(stderr, "Using positional stream\n");
+	}
+	if ((use_push != NULL) && !parameters.quiet) {
+		fprintf(stderr, "Using push input check\n");
+	}
+	if ((use_region != NULL) && !parameters.quiet) {
+		fprintf(stderr, "Using read region check\n");
+	}
+#if !defined(YABMP_HAVE_PREAD)
+	if ((use_threads != NULL) && (use_positional != NULL)) {
+		/* yabmp_file_read_at can't be called concurrently */
+		use_threads = NULL;
+	}
+#endif
+	if (use_threads != NULL) {
+		parameters.parallel_decode = 1;
+		if (!parameters.quiet) {
+			fprintf(stderr, "Using parallel decoding\n");
+		}
+	}
 	
 	for (;;)
 	{
 		yabmp* l_bmp_reader = NULL;
 		yabmp_info* l_bmp_info = NULL;
+		void* l_arena = NULL;
 		
 		if (use_memory_stream != NULL) {
 			FILE* l_file = NULL;
@@ -332,7 +503,23 @@ int main(int argc, char* argv[])
 			}
 		}
 		
-		if (yabmp_create_reader(&l_bmp_reader, NULL, parameters.quiet ? NULL : print_yabmp_error, parameters.quiet ? NULL : print_yabmp_warning, NULL, (use_custom_malloc != NULL) ? custom_malloc : NULL, (use_custom_malloc != NULL) ? custom_free : NULL) != YABMP_OK) {
+		if ((use_arena != NULL) && !((parameters.input_file[0] == '-') && (parameters.input_file[1] == '\0'))) {
+			size_t l_arena_size = get_arena_size(parameters.input_file, input_data, input_data_size);
+			
+			l_arena = malloc(l_arena_size);
+			if (l_arena == NULL) {
+				if (!parameters.quiet) {
+					fprintf(stderr, "Can't allocate %lu bytes arena\n", (unsigned long)l_arena_size);
+				}
+				result = EXIT_FAILURE;
+				goto FREE_INSTANCE;
+			}
+			if (yabmp_create_reader_in_arena(&l_bmp_reader, NULL, parameters.quiet ? NULL : print_yabmp_error, parameters.quiet ? NULL : print_yabmp_warning, l_arena, l_arena_size) != YABMP_OK) {
+				result = EXIT_FAILURE;
+				goto FREE_INSTANCE;
+			}
+		}
+		else if (yabmp_create_reader(&l_bmp_reader, NULL, parameters.quiet ? NULL : print_yabmp_error, parameters.quiet ? NULL : print_yabmp_warning, NULL, (use_custom_malloc != NULL) ? custom_malloc : NULL, (use_custom_malloc != NULL) ? custom_free : NULL) != YABMP_OK) {
 			result = EXIT_FAILURE;
 			goto FREE_INSTANCE;
 		}
@@ -340,16 +527,45 @@ int main(int argc, char* argv[])
 			result = EXIT_FAILURE;
 			goto FREE_INSTANCE;
 		}
+		if (use_read_buffer != NULL) {
+			if (yabmp_set_read_buffer_size(l_bmp_reader, 4096U) != YABMP_OK) {
+				result = EXIT_FAILURE;
+				goto FREE_INSTANCE;
+			}
+		}
+		if (use_threads != NULL) {
+			if (yabmp_set_decode_threads(l_bmp_reader, 4U, NULL, NULL) != YABMP_OK) {
+				result = EXIT_FAILURE;
+				goto FREE_INSTANCE;
+			}
+		}
 		if (input_data != NULL) {
 			if (yabmp_set_input_memory(l_bmp_reader, input_data, input_data_size) != YABMP_OK) {
 				result = EXIT_FAILURE;
 				goto FREE_INSTANCE;
 			}
+			parameters.memory_stream = 1;
 		}
 		else if ((parameters.input_file[0] == '-') && (parameters.input_file[1] == '\0')) {
 			stream_setmode_binary(stdin, parameters.quiet);
 			/* This can't fail with proper arguments */
 			(void)yabmp_set_input_stream(l_bmp_reader, stdin, yabmp_file_read, parameters.no_seek_fn ? NULL : yabmp_file_seek, NULL);
+		} else if (use_mmap != NULL) {
+			if (yabmp_set_input_file_mmap(l_bmp_reader, parameters.input_file) != YABMP_OK) {
+				result = EXIT_FAILURE;
+				goto FREE_INSTANCE;
+			}
+		} else if (use_positional != NULL) {
+			FILE* l_file = fopen(parameters.input_file, "rb");
+			if (l_file == NULL) {
+				if (!parameters.quiet) {
+					fprintf(stderr, "Can't open file '%s'\n", parameters.input_file);
+				}
+				result = EXIT_FAILURE;
+				goto FREE_INSTANCE;
+			}
+			/* This can't fail with proper arguments */
+			(void)yabmp_set_input_stream_positional(l_bmp_reader, l_file, yabmp_file_read_at, yabmp_file_close);
 		} else {
 			if (yabmp_set_input_file(l_bmp_reader, parameters.input_file) != YABMP_OK) {
 				result = EXIT_FAILURE;
@@ -362,8 +578,17 @@ int main(int argc, char* argv[])
 		}
 		/* yabmp_printinfo(stdout, l_bmp_reader, 0); */
 		result = convert_topng(&parameters, l_bmp_reader, l_bmp_info);
+		if ((result == 0) && (use_push != NULL)) {
+			/* same image decoded from pushed chunks */
+			result = check_push(&parameters);
+		}
+		if ((result == 0) && (use_region != NULL)) {
+			/* regions decoded on their own */
+			result = check_region(&parameters);
+		}
 FREE_INSTANCE:
 		yabmp_destroy_reader(&l_bmp_reader, &l_bmp_info);
+		free(l_arena);
 		if (input_data != NULL) {
 			if (use_custom_malloc != NULL) {
 				custom_free(NULL, input_data);
@@ -39,10 +39,18 @@ typedef struct
 	unsigned int quiet:1;
 	unsigned int expand_palette:1;
 	unsigned int keep_gray_palette:1;
+	unsigned int expand_alpha:1;
+	unsigned int alpha_first:1;
+	unsigned int rgb_to_gray:1;
+	unsigned int luma_weights:1; /* YABMP_LUMA_BT601 or YABMP_LUMA_BT709 */
 	unsigned int no_seek_fn:1;
+	unsigned int memory_stream:1;
+	unsigned int parallel_decode:1;
 	
 } yabmpconvert_parameters;
 
 int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader, yabmp_info* bmp_info);
+int check_push(const yabmpconvert_parameters* parameters);
+int check_region(const yabmpconvert_parameters* parameters);
 
 #endif /* YABMPCONVERT_H */
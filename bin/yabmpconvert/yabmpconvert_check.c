@@ -0,0 +1,489 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Matthieu DARBOIS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+#include <yabmp.h>
+
+#include "yabmpconvert.h"
+
+/* Checks decode the input a second time through another code path & compare against a memory stream decode */
+
+#define CHECK_PASS_RAW       0U /* no transforms */
+#define CHECK_PASS_EXPAND    1U /* palette & bitfields expanded to BGR(A) */
+#define CHECK_PASS_GRAYSCALE 2U /* gray palette expanded to Y8 */
+#define CHECK_PASS_COUNT     3U
+
+#define CHECK_PUSH_CHUNK_SIZE 7U /* small & odd, fields are split across chunks */
+
+typedef struct
+{
+	yabmp_uint8* pixels;
+	size_t       row_bytes;
+	yabmp_uint32 width;
+	yabmp_uint32 height;
+	unsigned int pixel_bits;
+} check_image;
+
+typedef struct
+{
+	yabmp_uint32 x;
+	yabmp_uint32 y;
+	yabmp_uint32 width;
+	yabmp_uint32 height;
+	unsigned int memory:1; /* memory input, file input otherwise */
+	unsigned int image:1;  /* yabmp_read_image with decoding threads, yabmp_read_row otherwise */
+	unsigned int invert:1; /* inverted scan direction */
+} check_region_desc;
+
+typedef struct
+{
+	unsigned int pass;
+	check_image  image;
+	yabmp_uint32 row_count;
+} check_push_context;
+
+static void* load_file(const char* path, size_t* size)
+{
+	FILE* l_file;
+	void* l_data = NULL;
+	long l_len;
+	
+	*size = 0U;
+	l_file = fopen(path, "rb");
+	if (l_file == NULL) {
+		return NULL;
+	}
+	if ((fseek(l_file, 0, SEEK_END) == 0) && ((l_len = ftell(l_file)) > 0)) {
+		rewind(l_file);
+		l_data = malloc((size_t)l_len);
+		if ((l_data != NULL) && (fread(l_data, 1U, (size_t)l_len, l_file) != (size_t)l_len)) {
+			free(l_data);
+			l_data = NULL;
+		}
+		if (l_data != NULL) {
+			*size = (size_t)l_len;
+		}
+	}
+	fclose(l_file);
+	return l_data;
+}
+
+/* returns 0 when applied, 1 when the pass doesn't apply to this image, -1 on error */
+static int set_transforms(yabmp* reader, yabmp_info* info, unsigned int pass)
+{
+	unsigned int l_color_type;
+	yabmp_status l_status = YABMP_OK;
+	
+	if (yabmp_get_color_type(reader, info, &l_color_type) != YABMP_OK) {
+		return -1;
+	}
+	switch (pass) {
+		case CHECK_PASS_EXPAND:
+			if ((l_color_type & (YABMP_COLOR_MASK_PALETTE | YABMP_COLOR_MASK_BITFIELDS)) == 0U) {
+				return 1;
+			}
+			l_status = yabmp_set_expand_to_bgrx(reader);
+			break;
+		case CHECK_PASS_GRAYSCALE:
+			if (l_color_type != YABMP_COLOR_TYPE_GRAY_PALETTE) {
+				return 1;
+			}
+			l_status = yabmp_set_expand_to_grayscale(reader);
+			break;
+		case CHECK_PASS_RAW:
+		default:
+			break;
+	}
+	if ((l_status != YABMP_OK) || (yabmp_read_update_info(reader, info) != YABMP_OK)) {
+		return -1;
+	}
+	return 0;
+}
+
+static int allocate_image(yabmp* reader, yabmp_info* info, check_image* image)
+{
+	unsigned int l_color_type;
+	unsigned int l_bit_depth;
+	
+	if ((yabmp_get_dimensions(reader, info, &image->width, &image->height) != YABMP_OK) || (yabmp_get_rowbytes(reader, info, &image->row_bytes) != YABMP_OK)) {
+		return -1;
+	}
+	if ((yabmp_get_color_type(reader, info, &l_color_type) != YABMP_OK) || (yabmp_get_bit_depth(reader, info, &l_bit_depth) != YABMP_OK)) {
+		return -1;
+	}
+	switch (l_color_type) {
+		case YABMP_COLOR_TYPE_BGR:
+			image->pixel_bits = 3U * l_bit_depth;
+			break;
+		case YABMP_COLOR_TYPE_BGR_ALPHA:
+			image->pixel_bits = 4U * l_bit_depth;
+			break;
+		default: /* one sample per pixel */
+			image->pixel_bits = l_bit_depth;
+			break;
+	}
+	/* TODO check overflow */
+	image->pixels = (yabmp_uint8*)calloc((size_t)image->height, image->row_bytes);
+	if (image->pixels == NULL) {
+		return -1;
+	}
+	return 0;
+}
+
+/* full image decoded from memory, returns 1 when the pass doesn't apply or the image can't be decoded */
+static int read_reference(const void* data, size_t data_size, unsigned int pass, check_image* image)
+{
+	int l_result = 1;
+	yabmp* l_reader = NULL;
+	yabmp_info* l_info = NULL;
+	
+	image->pixels = NULL;
+	if ((yabmp_create_reader(&l_reader, NULL, NULL, NULL, NULL, NULL, NULL) != YABMP_OK) || (yabmp_create_info(l_reader, &l_info) != YABMP_OK)) {
+		l_result = -1;
+		goto BADEND;
+	}
+	if ((yabmp_set_input_memory(l_reader, data, data_size) != YABMP_OK) || (yabmp_read_info(l_reader, l_info) != YABMP_OK)) {
+		goto BADEND;
+	}
+	l_result = set_transforms(l_reader, l_info, pass);
+	if (l_result != 0) {
+		goto BADEND;
+	}
+	l_result = allocate_image(l_reader, l_info, image);
+	if (l_result != 0) {
+		goto BADEND;
+	}
+	if (yabmp_read_image(l_reader, image->pixels, image->row_bytes) != YABMP_OK) {
+		l_result = 1;
+	}
+BADEND:
+	if ((l_result != 0) && (image->pixels != NULL)) {
+		free(image->pixels);
+		image->pixels = NULL;
+	}
+	yabmp_destroy_reader(&l_reader, &l_info);
+	return l_result;
+}
+
+static yabmp_status push_info(void* context, yabmp* reader, yabmp_info* info)
+{
+	check_push_context* l_context = (check_push_context*)context;
+	
+	if ((set_transforms(reader, info, l_context->pass) != 0) || (allocate_image(reader, info, &l_context->image) != 0)) {
+		return YABMP_ERR_UNKNOW;
+	}
+	return YABMP_OK;
+}
+
+static yabmp_status push_row(void* context, yabmp_uint32 row_index, const void* row)
+{
+	check_push_context* l_context = (check_push_context*)context;
+	
+	if (row_index >= l_context->image.height) {
+		return YABMP_ERR_UNKNOW;
+	}
+	memcpy(l_context->image.pixels + (size_t)row_index * l_context->image.row_bytes, row, l_context->image.row_bytes);
+	l_context->row_count++;
+	return YABMP_OK;
+}
+
+/* pushes the whole input in small chunks */
+static int check_push_pass(const void* data, size_t data_size, unsigned int pass, const check_image* reference)
+{
+	int l_result = -1;
+	yabmp* l_reader = NULL;
+	yabmp_info* l_info = NULL;
+	check_push_context l_context;
+	size_t l_offset;
+	
+	memset(&l_context, 0, sizeof(l_context));
+	l_context.pass = pass;
+	
+	if ((yabmp_create_reader(&l_reader, NULL, NULL, NULL, NULL, NULL, NULL) != YABMP_OK) || (yabmp_create_info(l_reader, &l_info) != YABMP_OK)) {
+		goto BADEND;
+	}
+	if (yabmp_set_input_push(l_reader, l_info, &l_context, push_info, push_row) != YABMP_OK) {
+		goto BADEND;
+	}
+	for (l_offset = 0U; l_offset < data_size; l_offset += CHECK_PUSH_CHUNK_SIZE) {
+		size_t l_count = data_size - l_offset;
+		
+		if (l_count > CHECK_PUSH_CHUNK_SIZE) {
+			l_count = CHECK_PUSH_CHUNK_SIZE;
+		}
+		if (yabmp_push_data(l_reader, (const yabmp_uint8*)data + l_offset, l_count) != YABMP_OK) {
+			goto BADEND;
+		}
+	}
+	if ((l_context.image.pixels != NULL) && (l_context.row_count == reference->height) && (l_context.image.row_bytes == reference->row_bytes) &&
+			(memcmp(l_context.image.pixels, reference->pixels, (size_t)reference->height * reference->row_bytes) == 0)) {
+		l_result = 0;
+	}
+BADEND:
+	free(l_context.image.pixels);
+	yabmp_destroy_reader(&l_reader, &l_info);
+	return l_result;
+}
+
+int check_push(const yabmpconvert_parameters* parameters)
+{
+	int l_result = 0;
+	void* l_data;
+	size_t l_data_size;
+	unsigned int l_pass;
+	
+	assert(parameters != NULL);
+	
+	if ((parameters->input_file[0] == '-') && (parameters->input_file[1] == '\0')) {
+		/* stdin was already consumed */
+		return 0;
+	}
+	l_data = load_file(parameters->input_file, &l_data_size);
+	if (l_data == NULL) {
+		if (!parameters->quiet) {
+			fprintf(stderr, "Couldn't read file '%s'\n", parameters->input_file);
+		}
+		return EXIT_FAILURE;
+	}
+	for (l_pass = 0U; l_pass < CHECK_PASS_COUNT; ++l_pass) {
+		check_image l_reference;
+		int l_status = read_reference(l_data, l_data_size, l_pass, &l_reference);
+		
+		if (l_status > 0) {
+			continue;
+		}
+		if ((l_status < 0) || (check_push_pass(l_data, l_data_size, l_pass, &l_reference) != 0)) {
+			if (!parameters->quiet) {
+				fprintf(stderr, "ERROR: push decoding differs from memory decoding (pass %u)\n", l_pass);
+			}
+			l_result = EXIT_FAILURE;
+		}
+		free(l_reference.pixels);
+		if (l_result != 0) {
+			break;
+		}
+	}
+	free(l_data);
+	return l_result;
+}
+
+/* pixel value for less than 8 bits per pixel, first pixel in most significant bits */
+static unsigned int get_pixel_bits(const yabmp_uint8* row, yabmp_uint32 index, unsigned int pixel_bits)
+{
+	size_t l_bit = (size_t)index * pixel_bits;
+	
+	return (row[l_bit / 8U] >> (8U - pixel_bits - (unsigned int)(l_bit % 8U))) & ((1U << pixel_bits) - 1U);
+}
+
+/* region decoded on its own, returns 1 when the region can't be decoded */
+static int read_region(const yabmpconvert_parameters* parameters, const void* data, size_t data_size, unsigned int pass, const check_region_desc* region, check_image* image)
+{
+	int l_result = -1;
+	yabmp* l_reader = NULL;
+	yabmp_info* l_info = NULL;
+	yabmp_uint32 l_compression;
+	yabmp_status l_status;
+	
+	image->pixels = NULL;
+	if ((yabmp_create_reader(&l_reader, NULL, NULL, NULL, NULL, NULL, NULL) != YABMP_OK) || (yabmp_create_info(l_reader, &l_info) != YABMP_OK)) {
+		goto BADEND;
+	}
+	if (region->memory) {
+		l_status = yabmp_set_input_memory(l_reader, data, data_size);
+	} else {
+		l_status = yabmp_set_input_file(l_reader, parameters->input_file);
+	}
+	if ((l_status != YABMP_OK) || (yabmp_read_info(l_reader, l_info) != YABMP_OK) || (yabmp_get_compression_type(l_reader, l_info, &l_compression) != YABMP_OK)) {
+		goto BADEND;
+	}
+	if (region->invert) {
+		if (yabmp_set_invert_scan_direction(l_reader) != YABMP_OK) {
+			goto BADEND;
+		}
+		if (!region->image && (l_compression != YABMP_COMPRESSION_NONE)) {
+			/* rows are read backward using a row index */
+			if (yabmp_build_row_index(l_reader) != YABMP_OK) {
+				goto BADEND;
+			}
+		}
+	}
+	if (yabmp_set_read_region(l_reader, region->x, region->y, region->width, region->height) != YABMP_OK) {
+		goto BADEND;
+	}
+	if ((set_transforms(l_reader, l_info, pass) != 0) || (allocate_image(l_reader, l_info, image) != 0)) {
+		goto BADEND;
+	}
+	if ((image->width != region->width) || (image->height != region->height)) {
+		goto BADEND;
+	}
+	if (region->image) {
+		if ((yabmp_set_decode_threads(l_reader, 4U, NULL, NULL) != YABMP_OK) || (yabmp_read_image(l_reader, image->pixels, image->row_bytes) != YABMP_OK)) {
+			goto BADEND;
+		}
+	}
+	else {
+		yabmp_uint32 i;
+		
+		for (i = 0U; i < image->height; ++i) {
+			if (yabmp_read_row(l_reader, image->pixels + (size_t)i * image->row_bytes, image->row_bytes) != YABMP_OK) {
+				goto BADEND;
+			}
+		}
+	}
+	l_result = 0;
+BADEND:
+	if ((l_result != 0) && (image->pixels != NULL)) {
+		free(image->pixels);
+		image->pixels = NULL;
+	}
+	yabmp_destroy_reader(&l_reader, &l_info);
+	return l_result;
+}
+
+/* compares a region with the same pixels of the full image decoded in file order */
+static int compare_region(const check_image* reference, const check_region_desc* region, const check_image* image)
+{
+	yabmp_uint32 i, j;
+	
+	if (image->pixel_bits != reference->pixel_bits) {
+		return -1;
+	}
+	for (i = 0U; i < region->height; ++i) {
+		yabmp_uint32 l_reference_row = region->y + i;
+		const yabmp_uint8* l_expected;
+		const yabmp_uint8* l_actual = image->pixels + (size_t)i * image->row_bytes;
+		
+		if (region->invert) {
+			l_reference_row = reference->height - 1U - l_reference_row;
+		}
+		l_expected = reference->pixels + (size_t)l_reference_row * reference->row_bytes;
+		if ((reference->pixel_bits % 8U) == 0U) {
+			size_t l_pixel_bytes = reference->pixel_bits / 8U;
+			
+			if (memcmp(l_actual, l_expected + (size_t)region->x * l_pixel_bytes, (size_t)region->width * l_pixel_bytes) != 0) {
+				return -1;
+			}
+		}
+		else {
+			for (j = 0U; j < region->width; ++j) {
+				if (get_pixel_bits(l_actual, j, image->pixel_bits) != get_pixel_bits(l_expected, region->x + j, reference->pixel_bits)) {
+					return -1;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+int check_region(const yabmpconvert_parameters* parameters)
+{
+	int l_result = 0;
+	void* l_data;
+	size_t l_data_size;
+	unsigned int l_pass;
+	
+	assert(parameters != NULL);
+	
+	if ((parameters->input_file[0] == '-') && (parameters->input_file[1] == '\0')) {
+		/* stdin was already consumed */
+		return 0;
+	}
+	l_data = load_file(parameters->input_file, &l_data_size);
+	if (l_data == NULL) {
+		if (!parameters->quiet) {
+			fprintf(stderr, "Couldn't read file '%s'\n", parameters->input_file);
+		}
+		return EXIT_FAILURE;
+	}
+	for (l_pass = 0U; (l_pass < CHECK_PASS_COUNT) && (l_result == 0); ++l_pass) {
+		check_image l_reference;
+		check_region_desc l_regions[6];
+		yabmp_uint32 l_width, l_height;
+		unsigned int i;
+		int l_status = read_reference(l_data, l_data_size, l_pass, &l_reference);
+		
+		if (l_status > 0) {
+			continue;
+		}
+		if (l_status < 0) {
+			l_result = EXIT_FAILURE;
+			break;
+		}
+		l_width = l_reference.width;
+		l_height = l_reference.height;
+		memset(l_regions, 0, sizeof(l_regions));
+		/* centered, columns not aligned on bytes for less than 8 bits per pixel */
+		l_regions[0].x = l_width / 3U;
+		l_regions[0].y = l_height / 3U;
+		l_regions[0].width = l_width - l_regions[0].x - l_width / 5U;
+		l_regions[0].height = l_height - l_regions[0].y - l_height / 4U;
+		/* last column */
+		l_regions[1].x = l_width - 1U;
+		l_regions[1].width = 1U;
+		l_regions[1].height = l_height;
+		l_regions[1].memory = 1U;
+		/* last row */
+		l_regions[2].y = l_height - 1U;
+		l_regions[2].width = l_width;
+		l_regions[2].height = 1U;
+		l_regions[2].image = 1U;
+		/* odd offset */
+		l_regions[3].x = (l_width > 7U) ? 7U : 0U;
+		l_regions[3].y = (l_height > 3U) ? 3U : 0U;
+		l_regions[3].width = l_width - l_regions[3].x - (l_width - l_regions[3].x) / 3U;
+		l_regions[3].height = (l_height - l_regions[3].y + 1U) / 2U;
+		l_regions[3].memory = 1U;
+		l_regions[3].image = 1U;
+		/* inverted scan direction */
+		l_regions[4] = l_regions[0];
+		l_regions[4].invert = 1U;
+		l_regions[4].memory = 1U;
+		l_regions[4].image = 1U;
+		l_regions[5] = l_regions[3];
+		l_regions[5].invert = 1U;
+		l_regions[5].memory = 0U;
+		l_regions[5].image = 0U;
+		
+		for (i = 0U; i < sizeof(l_regions) / sizeof(l_regions[0]); ++i) {
+			check_image l_image;
+			
+			if ((read_region(parameters, l_data, l_data_size, l_pass, &l_regions[i], &l_image) != 0) || (compare_region(&l_reference, &l_regions[i], &l_image) != 0)) {
+				if (!parameters->quiet) {
+					fprintf(stderr, "ERROR: region %u differs from full image decoding (pass %u)\n", i, l_pass);
+				}
+				l_result = EXIT_FAILURE;
+			}
+			free(l_image.pixels);
+			if (l_result != 0) {
+				break;
+			}
+		}
+		free(l_reference.pixels);
+	}
+	free(l_data);
+	return l_result;
+}
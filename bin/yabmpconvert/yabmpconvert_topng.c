@@ -96,23 +96,29 @@ static void stream_setmode_binary(FILE* stream, unsigned int quiet)
 #endif
 }
 
+/* expand to BGR(A) or Y8, alpha is always added when requested */
+static yabmp_status set_expand(const yabmpconvert_parameters* parameters, yabmp* bmp_reader)
+{
+	if (parameters->rgb_to_gray) {
+		return yabmp_set_rgb_to_gray(bmp_reader, parameters->luma_weights);
+	}
+	if (parameters->expand_alpha) {
+		return yabmp_set_expand_to_bgra(bmp_reader);
+	}
+	return yabmp_set_expand_to_bgrx(bmp_reader);
+}
+
 int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader, yabmp_info* bmp_info)
 {
 	int result = EXIT_FAILURE; /* default is fail */
 	void* volatile l_buffer = NULL; /* volatile needed because of long jump */
 	void* l_buffer_cache;
 	size_t l_buffer_size;
-	yabmp_uint32 l_width, l_height;
-	yabmp_uint32 l_res_x, l_res_y;
-	unsigned int l_bit_depth;
-	unsigned int l_color_type;
-	yabmp_uint32 l_compression_type;
-	unsigned int l_scan_direction;
+	yabmp_header_desc l_desc;
 	yabmp_uint32 l_png_color_mask;
 	int l_png_has_sBIT = 0;
-	unsigned int blue_bits, green_bits, red_bits, alpha_bits;
-	unsigned int l_color_profile_type, l_color_profile_intent;
 	int l_need_full_image = 0;
+	int l_zero_copy = parameters->memory_stream; /* rows can be referenced when no transforms are used */
 		
 	png_structp l_png_writer = NULL;
 	png_infop l_png_info = NULL;
@@ -122,36 +128,44 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 	assert(bmp_reader != NULL);
 	assert(bmp_info != NULL);
 	
-	/* Those calls can't fail with proper arguments */
-	(void)yabmp_get_color_type(bmp_reader, bmp_info, &l_color_type);
-	(void)yabmp_get_compression_type(bmp_reader, bmp_info, &l_compression_type);
-	(void)yabmp_get_scan_direction(bmp_reader, bmp_info, &l_scan_direction);
-	(void)yabmp_get_color_profile_type(bmp_reader, bmp_info, &l_color_profile_type);
-	(void)yabmp_get_color_profile_intent(bmp_reader, bmp_info, &l_color_profile_intent);
+	/* This call can't fail with proper arguments */
+	l_desc.struct_size = sizeof(l_desc);
+	(void)yabmp_get_header_desc(bmp_reader, bmp_info, &l_desc);
 	
 	/* Check transforms needed */
-	switch (l_color_type)
+	switch (l_desc.color_type)
 	{
 		case YABMP_COLOR_TYPE_BGR:
+			if (parameters->expand_alpha || parameters->rgb_to_gray) {
+				set_expand(parameters, bmp_reader); /* opaque alpha added to 24bpp rows or Y8 */
+				l_zero_copy = 0;
+			}
 			break;
 		case YABMP_COLOR_TYPE_BITFIELDS:
-			yabmp_set_expand_to_bgrx(bmp_reader); /* always expand to BGR(A) */
+			set_expand(parameters, bmp_reader); /* always expand to BGR(A) */
+			yabmp_set_scale_to_full_range(bmp_reader); /* replaces png_set_shift */
+			l_zero_copy = 0;
 			break;
 		case YABMP_COLOR_TYPE_BITFIELDS_ALPHA:
-			yabmp_set_expand_to_bgrx(bmp_reader); /* always expand to BGR(A) */
+			set_expand(parameters, bmp_reader); /* always expand to BGR(A) */
+			yabmp_set_scale_to_full_range(bmp_reader); /* replaces png_set_shift */
+			l_zero_copy = 0;
 			break;
 		case YABMP_COLOR_TYPE_PALETTE:
-			if (parameters->expand_palette) {
-				yabmp_set_expand_to_bgrx(bmp_reader); /* expand to BGR(A) */
+			if (parameters->expand_palette || parameters->rgb_to_gray) {
+				set_expand(parameters, bmp_reader); /* expand to BGR(A) or Y8 */
+				l_zero_copy = 0;
 			}
 			break;
 		case YABMP_COLOR_TYPE_GRAY_PALETTE:
-			if (parameters->expand_palette) {
-				yabmp_set_expand_to_bgrx(bmp_reader); /* always expand to BGR(A) */
+			if (parameters->expand_palette || parameters->rgb_to_gray) {
+				set_expand(parameters, bmp_reader); /* always expand to BGR(A) or Y8 */
+				l_zero_copy = 0;
 			} else if (parameters->keep_gray_palette) {
 				/* Nothing to do */
 			} else {
 				yabmp_set_expand_to_grayscale(bmp_reader); /* always expand to Y8 */
+				l_zero_copy = 0;
 			}
 			break;
 		default:
@@ -160,39 +174,50 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 			}
 			return EXIT_FAILURE;
 	}
-	switch (l_scan_direction)
+	switch (l_desc.scan_direction)
 	{
 		case YABMP_SCAN_BOTTOM_UP:
-			switch (l_compression_type) {
-				case YABMP_COMPRESSION_NONE:
-					if (parameters->no_seek_fn) {
-						/* no seek for stdin */
-						l_need_full_image = 1;
-					} else {
-						if (yabmp_set_invert_scan_direction(bmp_reader) != YABMP_OK) {
-							return EXIT_FAILURE;
-						}
-					}
-					break;
-				default:
-					l_need_full_image = 1;
-					break;
+			if (yabmp_set_invert_scan_direction(bmp_reader) != YABMP_OK) {
+				return EXIT_FAILURE;
+			}
+			if (parameters->no_seek_fn) {
+				/* no seek for stdin, rows can't be read backward one by one */
+				l_need_full_image = 1;
+			} else if (l_desc.compression != YABMP_COMPRESSION_NONE) {
+				/* rows will be read backward using a row index */
+				if (yabmp_build_row_index(bmp_reader) != YABMP_OK) {
+					return EXIT_FAILURE;
+				}
 			}
 			break;
 		default:
 		case YABMP_SCAN_TOP_DOWN:
 			break;
 	}
+	if (l_desc.compression != YABMP_COMPRESSION_NONE) {
+		l_zero_copy = 0;
+	}
+	if (parameters->parallel_decode) {
+		/* bands are decoded in parallel by yabmp_read_image */
+		l_need_full_image = 1;
+		l_zero_copy = 0;
+	}
+	/* rows are written in PNG layout unless they are referenced as is */
+	if (!l_zero_copy) {
+		unsigned int l_output_format = YABMP_OUTPUT_RGB | YABMP_OUTPUT_BIG_ENDIAN;
+		
+		if (parameters->alpha_first) {
+			l_output_format |= YABMP_OUTPUT_ALPHA_FIRST;
+		}
+		if (yabmp_set_output_format(bmp_reader, l_output_format) != YABMP_OK) {
+			return EXIT_FAILURE;
+		}
+	}
 	/* Update infos & set PNG parameters */
 	yabmp_read_update_info(bmp_reader, bmp_info);
+	(void)yabmp_get_header_desc(bmp_reader, bmp_info, &l_desc);
 	
-	(void)yabmp_get_color_type(bmp_reader, bmp_info, &l_color_type);
-	(void)yabmp_get_dimensions(bmp_reader, bmp_info, &l_width, &l_height);
-	(void)yabmp_get_pixels_per_meter(bmp_reader, bmp_info, &l_res_x, &l_res_y);
-	(void)yabmp_get_bit_depth(bmp_reader, bmp_info, &l_bit_depth);
-	(void)yabmp_get_bits(bmp_reader, bmp_info, &blue_bits, &green_bits, &red_bits, &alpha_bits);
-	
-	switch (l_color_type)
+	switch (l_desc.color_type)
 	{
 		case YABMP_COLOR_TYPE_BGR:
 			l_png_color_mask = PNG_COLOR_TYPE_RGB;
@@ -215,10 +240,10 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 	}
 	
 	if (
-			(blue_bits != l_bit_depth) ||
-			(green_bits != l_bit_depth) ||
-			(red_bits != l_bit_depth) ||
-			((alpha_bits != l_bit_depth) && (alpha_bits != 0))) {
+			(l_desc.blue_bits != l_desc.bit_depth) ||
+			(l_desc.green_bits != l_desc.bit_depth) ||
+			(l_desc.red_bits != l_desc.bit_depth) ||
+			((l_desc.alpha_bits != l_desc.bit_depth) && (l_desc.alpha_bits != 0))) {
 		l_png_has_sBIT = 1;
 	}
 	
@@ -256,18 +281,18 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 		goto BADEND;
 	}
 		
-	png_set_IHDR(l_png_writer, l_png_info, l_width, l_height, (int)l_bit_depth, l_png_color_mask, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_set_IHDR(l_png_writer, l_png_info, l_desc.width, l_desc.height, (int)l_desc.bit_depth, l_png_color_mask, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
 	
-	if ((l_res_x != 0U) || (l_res_y != 0U)) {
-		png_set_pHYs(l_png_writer, l_png_info, l_res_x, l_res_y, PNG_RESOLUTION_METER);
+	if ((l_desc.res_ppm_x != 0U) || (l_desc.res_ppm_y != 0U)) {
+		png_set_pHYs(l_png_writer, l_png_info, l_desc.res_ppm_x, l_desc.res_ppm_y, PNG_RESOLUTION_METER);
 	}
 	
 	if (l_png_color_mask == PNG_COLOR_TYPE_PALETTE) {
-		unsigned int i, l_num_palette;
-		const yabmp_color *l_bmp_palette;
+		unsigned int i, l_num_palette = l_desc.palette_count;
+		const yabmp_color *l_bmp_palette = l_desc.palette;
 		png_color l_png_palette[256];
 		
-		if(yabmp_get_palette(bmp_reader, bmp_info, &l_num_palette, &l_bmp_palette) != YABMP_OK) {
+		if (l_bmp_palette == NULL) {
 			goto BADEND;
 		}
 		assert(l_num_palette <= 256U);
@@ -284,33 +309,24 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 		png_color_8 l_sBIT;
 		
 		if ((l_png_color_mask & ~PNG_COLOR_MASK_ALPHA) == PNG_COLOR_TYPE_RGB) {
-			l_sBIT.alpha = alpha_bits;
+			l_sBIT.alpha = l_desc.alpha_bits;
 			l_sBIT.gray  = 0U;
-			l_sBIT.blue  = blue_bits ? blue_bits : 1; /* 0 is forbidden, transform deadlocks */
-			l_sBIT.green = green_bits ? green_bits : 1;
-			l_sBIT.red   = red_bits ? red_bits : 1;
+			l_sBIT.blue  = l_desc.blue_bits ? l_desc.blue_bits : 1; /* 0 is forbidden, transform deadlocks */
+			l_sBIT.green = l_desc.green_bits ? l_desc.green_bits : 1;
+			l_sBIT.red   = l_desc.red_bits ? l_desc.red_bits : 1;
 			png_set_sBIT(l_png_writer, l_png_info, &l_sBIT);
-			
-			/* because of png_set_bgr */
-			l_sBIT.blue  = red_bits ? red_bits : 1;
-			l_sBIT.red   = blue_bits ? blue_bits : 1;
-			png_set_shift(l_png_writer, &l_sBIT);
+			/* samples are already scaled to full range by yabmp_set_scale_to_full_range */
 		}
 	}
 	
-	switch (l_color_profile_type) {
+	switch (l_desc.color_profile_type) {
 		case YABMP_COLOR_PROFILE_ICC_EMBEDDED:
-			{
-				yabmp_uint8 const* l_icc_profile = NULL;
-				yabmp_uint32 l_icc_profile_len;
-				(void)yabmp_get_color_profile_icc_data(bmp_reader, bmp_info, &l_icc_profile, &l_icc_profile_len);
-				png_set_iCCP(l_png_writer, l_png_info, "bmpiccprofile", 0, l_icc_profile, l_icc_profile_len);
-			}
+			png_set_iCCP(l_png_writer, l_png_info, "bmpiccprofile", 0, l_desc.icc_profile, l_desc.icc_profile_len);
 			break;
 		case YABMP_COLOR_PROFILE_sRGB:
 			{
 				int srgb_intent;
-				switch (l_color_profile_intent) {
+				switch (l_desc.color_profile_intent) {
 					case YABMP_COLOR_PROFILE_INTENT_NONE:
 					case YABMP_COLOR_PROFILE_INTENT_PERCEPTUAL:
 						srgb_intent = 0;
@@ -336,9 +352,8 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 			break;
 		case YABMP_COLOR_PROFILE_CALIBRATED_RGB:
 			{
-				yabmp_cie_xyz r, g, b;
-				yabmp_q16d16 gr, gg, gb;
-				(void)yabmp_get_color_profile_calibration(bmp_reader, bmp_info, &r, &g, &b, &gr, &gg, &gb);
+				const yabmp_cie_xyz r = l_desc.cie_r, g = l_desc.cie_g, b = l_desc.cie_b;
+				const yabmp_q16d16 gr = l_desc.gamma_r, gg = l_desc.gamma_g, gb = l_desc.gamma_b;
 				png_set_cHRM_XYZ(l_png_writer, l_png_info, r.x * (1.0 / 1073741823.0), r.y * (1.0 / 1073741823.0), r.z * (1.0 / 1073741823.0), g.x * (1.0 / 1073741823.0), g.y * (1.0 / 1073741823.0), g.z * (1.0 / 1073741823.0), b.x * (1.0 / 1073741823.0), b.y * (1.0 / 1073741823.0), b.z * (1.0 / 1073741823.0));
 				/* how to handle per channel gamma ? */
 				/* let's just average for now... */
@@ -351,35 +366,33 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 	
 	png_write_info(l_png_writer, l_png_info);
 		
-	switch (l_png_color_mask) {
-		case PNG_COLOR_TYPE_RGB:
-		case PNG_COLOR_TYPE_RGB_ALPHA:
-			png_set_bgr(l_png_writer);
-			break;
-		default:
-			break;
+	if (l_zero_copy) {
+		/* referenced rows are never expanded, those are BGR with 8 bits samples */
+		switch (l_png_color_mask) {
+			case PNG_COLOR_TYPE_RGB:
+			case PNG_COLOR_TYPE_RGB_ALPHA:
+				png_set_bgr(l_png_writer);
+				break;
+			default:
+				break;
+		}
 	}
-#if !defined(YABMP_BIG_ENDIAN)
-	if (l_bit_depth == 16U) {
-		png_set_swap(l_png_writer);
+	else if (parameters->alpha_first && (l_png_color_mask == PNG_COLOR_TYPE_RGB_ALPHA)) {
+		/* rows are read as ARGB */
+		png_set_swap_alpha(l_png_writer);
 	}
-#endif
 	
 	/* Now deal with the image */
 	l_buffer_size = png_get_rowbytes(l_png_writer, l_png_info);
-	{
-		size_t l_check_buffer_size;
-		yabmp_get_rowbytes(bmp_reader, bmp_info, &l_check_buffer_size);
-		if (l_check_buffer_size != l_buffer_size) {
-			if (!parameters->quiet) {
-				fprintf(stderr, "ERROR: row bytes not matching between YABMP & PNG\n");
-			}
-			goto BADEND;
+	if (l_desc.transformed_row_bytes != l_buffer_size) {
+		if (!parameters->quiet) {
+			fprintf(stderr, "ERROR: row bytes not matching between YABMP & PNG\n");
 		}
+		goto BADEND;
 	}
 	if (l_need_full_image) {
 		/* TODO check overflow */
-		l_buffer = l_buffer_cache = parameters->malloc ? parameters->malloc(NULL, l_buffer_size * (size_t)l_height) : malloc(l_buffer_size * (size_t)l_height);
+		l_buffer = l_buffer_cache = parameters->malloc ? parameters->malloc(NULL, l_buffer_size * (size_t)l_desc.height) : malloc(l_buffer_size * (size_t)l_desc.height);
 	}
 	else {
 		l_buffer = l_buffer_cache = parameters->malloc ? parameters->malloc(NULL, l_buffer_size): malloc(l_buffer_size);
@@ -398,21 +411,28 @@ int convert_topng(const yabmpconvert_parameters* parameters, yabmp* bmp_reader,
 		} l_current_row;
 		yabmp_uint32 i;
 		
+		if (yabmp_read_image(bmp_reader, l_buffer_cache, l_buffer_size) != YABMP_OK) {
+			goto BADEND;
+		}
 		l_current_row.buffer = l_buffer_cache;
-		for (i = 0U; i < l_height; ++i) {
-			if (yabmp_read_row(bmp_reader, l_current_row.buffer, l_buffer_size) != YABMP_OK) {
-				goto BADEND;
-			}
+		for (i = 0U; i < l_desc.height; ++i) {
+			png_write_row(l_png_writer, l_current_row.buffer);
 			l_current_row.buffer8u += l_buffer_size;
 		}
-		for (i = 0U; i < l_height; ++i) {
-			l_current_row.buffer8u -= l_buffer_size;
-			png_write_row(l_png_writer, l_current_row.buffer);
+	}
+	else if (l_zero_copy) {
+		yabmp_uint32 i;
+		for (i = 0U; i < l_desc.height; ++i) {
+			const void* l_row = NULL;
+			if (yabmp_read_row_ref(bmp_reader, &l_row) != YABMP_OK) {
+				goto BADEND;
+			}
+			png_write_row(l_png_writer, (png_bytep)l_row);
 		}
 	}
 	else {
 		yabmp_uint32 i;
-		for (i = 0U; i < l_height; ++i) {
+		for (i = 0U; i < l_desc.height; ++i) {
 			if (yabmp_read_row(bmp_reader, l_buffer_cache, l_buffer_size) != YABMP_OK) {
 				goto BADEND;
 			}
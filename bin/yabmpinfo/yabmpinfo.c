@@ -127,6 +127,8 @@ int main(int argc, char* argv[])
 	const char* input = NULL;
 	const char* last_input = NULL;
 	FILE* outStream = stdout;
+	yabmp* l_reader = NULL;
+	yabmp_info* l_info = NULL;
 	
 	argv[0] = (char*)yabmp_basename(argv[0]);
 	
@@ -198,11 +200,18 @@ int main(int argc, char* argv[])
 		}
 	}
 	
+	/* reader is reused for every file */
+	if (yabmp_create_reader(&l_reader, NULL, flags.quiet ? NULL : print_error, flags.quiet ? NULL : print_warning, NULL, NULL, NULL) != YABMP_OK) {
+		result = 1;
+		goto BADEND;
+	}
+	if (yabmp_create_info(l_reader, &l_info) != YABMP_OK) {
+		result = 1;
+		goto BADEND;
+	}
+	
 	do
 	{
-		yabmp* l_reader = NULL;
-		yabmp_info* l_info = NULL;
-		
 		if (has_multiple_files) {
 			if (last_input != NULL) {
 				fputc('\n', outStream);
@@ -210,13 +219,9 @@ int main(int argc, char* argv[])
 			last_input = input;
 			fprintf(outStream, "%s:\n", yabmp_basename(input));
 		}
-		if (yabmp_create_reader(&l_reader, NULL, flags.quiet ? NULL : print_error, flags.quiet ? NULL : print_warning, NULL, NULL, NULL) != YABMP_OK) {
-			result = 1;
-			goto FREE_INSTANCE;
-		}
-		if (yabmp_create_info(l_reader, &l_info) != YABMP_OK) {
+		if (yabmp_reset_reader(l_reader) != YABMP_OK) {
 			result = 1;
-			goto FREE_INSTANCE;
+			goto BADEND;
 		}
 		if ((input[0] == '-') && (input[1] == '\0')) {
 			stream_setmode_binary(stdin, flags.quiet);
@@ -225,21 +230,17 @@ int main(int argc, char* argv[])
 		} else {
 			if (yabmp_set_input_file(l_reader, input) != YABMP_OK) {
 				result = 1;
-				goto FREE_INSTANCE;
+				goto BADEND;
 			}
 		}
 		if (yabmp_read_info(l_reader, l_info) != YABMP_OK) {
 			result = 1;
-			goto FREE_INSTANCE;
-		}
-		yabmp_printinfo(outStream, l_reader, l_info);
-FREE_INSTANCE:
-		yabmp_destroy_reader(&l_reader, &l_info);
-		if (result) {
 			goto BADEND;
 		}
+		yabmp_printinfo(outStream, l_reader, l_info);
 	} while ((input = optparse_arg(&optparse)) != NULL);
 BADEND:
+	yabmp_destroy_reader(&l_reader, &l_info);
 	if ((outStream != stdout) && (outStream != NULL)) {
 		fclose(outStream);
 		if (result && !has_multiple_files) {
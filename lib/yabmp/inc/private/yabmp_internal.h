@@ -45,5 +45,6 @@
 #include "yabmp_stream.h"
 #include "yabmp_checks.h"
 #include "yabmp_rtransforms.h"
+#include "yabmp_threads.h"
 
 #endif /* YABMP_INTERNAL_H */
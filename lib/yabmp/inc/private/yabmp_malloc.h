@@ -31,6 +31,12 @@
 YABMP_IAPI(void*, yabmp_malloc, (const yabmp* instance, size_t size));
 YABMP_IAPI(void,  yabmp_free,   (const yabmp* instance, void* ptr));
 
+struct yabmp_arena_struct;
+
+YABMP_IAPI(size_t, yabmp_arena_block_size, (size_t size)); /* arena bytes used by an allocation of size bytes, 0 on overflow */
+YABMP_IAPI(void,   yabmp_arena_init,       (struct yabmp_arena_struct** arena, void* buffer, size_t buffer_size)); /* arena is NULL if buffer is too small */
+YABMP_IAPI(int,    yabmp_arena_fits,       (const yabmp* instance, size_t size, unsigned int count)); /* non zero if count allocations of size bytes would succeed */
+
 /* Let's poison malloc to avoid its use by accident */
 #if defined(__GNUC__) && !defined(YABMP_MALLOC_NO_POISON)
 #	pragma GCC poison malloc free realloc calloc
@@ -41,16 +41,82 @@ YABMP_IAPI(void, yabmp_bf32u_to_bgr24,  (const yabmp* instance, const yabmp_uint
 YABMP_IAPI(void, yabmp_bf32u_to_bgr48,  (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ));
 YABMP_IAPI(void, yabmp_bf32u_to_bgra32, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8*  pDst ));
 YABMP_IAPI(void, yabmp_bf32u_to_bgra64, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24,                 (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24,                 (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24_scaled,          (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24_scaled,          (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32,                (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32,                (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32_scaled,         (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32_scaled,         (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf32u_x8r8g8b8_to_bgr24,            (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf32u_a8r8g8b8_to_bgra32,           (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf32u_x8r8g8b8_to_bgra32,           (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf32u_a2r10g10b10_to_bgra64,        (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_a2r10g10b10_to_bgra64_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ));
+
+YABMP_IAPI(void, yabmp_bf16u_to_bgr24_scaled,  (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_to_bgr48_scaled,  (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_to_bgra32_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf16u_to_bgra64_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_to_bgr24_scaled,  (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf32u_to_bgr48_scaled,  (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_to_bgra32_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8*  pDst ));
+YABMP_IAPI(void, yabmp_bf32u_to_bgra64_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ));
+YABMP_IAPI(yabmp_uint32, yabmp_bitfield_replicate, (yabmp_uint32 value, unsigned int bits, unsigned int target_bits));
 YABMP_IAPI(void, yabmp_bitfield_get_shift_and_bits, (yabmp_uint32 mask, unsigned int* shift, unsigned int* bits));
 
+YABMP_IAPI(void, yabmp_prepare_expand_lut, (yabmp* instance, unsigned int bpp, unsigned int bytes_per_pixel));
+YABMP_IAPI(void, yabmp_prepare_palette_packed, (yabmp* instance));
+YABMP_IAPI(void, yabmp_prepare_palette_gray,   (yabmp* instance));
+YABMP_IAPI(void, yabmp_prepare_rle_lut,        (yabmp* instance, unsigned int bytes_per_pixel));
+
+YABMP_IAPI(void, yabmp_bgr24_to_rgb24,  (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bgr24_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+
 YABMP_IAPI(void, yabmp_pal1_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 YABMP_IAPI(void, yabmp_pal2_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 YABMP_IAPI(void, yabmp_pal4_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 YABMP_IAPI(void, yabmp_pal8_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 
+YABMP_IAPI(void, yabmp_pal1_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_pal2_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_pal4_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_pal8_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+
 YABMP_IAPI(void, yabmp_pal1_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 YABMP_IAPI(void, yabmp_pal2_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 YABMP_IAPI(void, yabmp_pal4_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 YABMP_IAPI(void, yabmp_pal8_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
 
+YABMP_IAPI(void, yabmp_bgr24_to_y8, (const yabmp* instance, const yabmp_uint8*  pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_to_y8, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_to_y8, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ));
+
+#if defined(YABMP_HAVE_X86_SIMD)
+#define YABMP_CPU_SSE41 1U
+#define YABMP_CPU_AVX2  2U
+
+YABMP_IAPI(unsigned int, yabmp_get_cpu_features, (void));
+
+YABMP_IAPI(void, yabmp_pal8_to_bgr24_sse41, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_pal8_to_bgr24_avx2,  (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_pal8_to_bgra32_avx2, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ));
+
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24_sse41,         (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24_sse41,         (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24_scaled_sse41,  (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24_scaled_sse41,  (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32_sse41,        (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32_sse41,        (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32_scaled_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32_scaled_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_x8r8g8b8_to_bgr24_sse41,    (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_8888_swizzle_sse41,         (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bgr24_to_rgb24_sse41,             (const yabmp* instance, const yabmp_uint8*  pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bgr24_to_bgra32_sse41,            (const yabmp* instance, const yabmp_uint8*  pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bgr24_to_y8_sse41,                (const yabmp* instance, const yabmp_uint8*  pSrc, yabmp_uint8* pDst ));
+YABMP_IAPI(void, yabmp_bf32u_8888_to_y8_sse41,           (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ));
+#endif
+
 #endif /* YABMP_RTRANSFORMS_H */
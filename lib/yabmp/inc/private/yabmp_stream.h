@@ -28,9 +28,20 @@
 
 #include "yabmp_internal.h"
 
+#define YABMP_RLE_READ_BUFFER_SIZE 4096U /* read-ahead buffer used for RLE data when none was set */
+
+YABMP_IAPI(size_t,       yabmp_stream_fetch, (yabmp* instance, void* buffer, size_t buffer_len)); /* no error message, returns bytes read */
 YABMP_IAPI(yabmp_status, yabmp_stream_read, (yabmp* instance, yabmp_uint8* buffer, size_t buffer_len));
+YABMP_IAPI(size_t,       yabmp_stream_window, (yabmp* reader, const yabmp_uint8** data)); /* bytes readable in place at current position, 0 when the stream must be read */
+YABMP_IAPI(void,         yabmp_stream_consume, (yabmp* reader, size_t count)); /* moves past count bytes of the window */
 YABMP_IAPI(yabmp_status, yabmp_stream_seek, (yabmp* reader, yabmp_uint32 offset)); /* max offset is on yabmp_uint32 for BMP */
 YABMP_IAPI(yabmp_status, yabmp_stream_skip, (yabmp* instance, yabmp_uint32 count));
+YABMP_IAPI(yabmp_status, yabmp_stream_push, (yabmp* reader, const yabmp_uint8* data, size_t data_size)); /* drops consumed bytes & appends data */
+YABMP_IAPI(yabmp_status, yabmp_stream_read_at, (yabmp* reader, yabmp_uint32 offset, yabmp_uint8* buffer, size_t buffer_len)); /* stream position is left untouched */
+YABMP_IAPI(void,         yabmp_stream_access_hint, (yabmp* reader, int backward)); /* image data is about to be read */
+YABMP_IAPI(yabmp_status, yabmp_stream_read_8u, (yabmp* instance, yabmp_uint8* value));
+YABMP_IAPI(yabmp_status, yabmp_stream_read_le_16u, (yabmp* instance, yabmp_uint16* value));
+YABMP_IAPI(yabmp_status, yabmp_stream_read_le_32u, (yabmp* instance, yabmp_uint32* value));
 
 #if defined(YABMP_BIG_ENDIAN)
 YABMP_UNUSED
@@ -58,61 +69,4 @@ static yabmp_uint32 yabmp_bswap32(yabmp_uint32 x)
 }
 #endif
 
-YABMP_UNUSED
-static yabmp_status yabmp_stream_read_8u(yabmp* instance, yabmp_uint8* value)
-{
-	yabmp_status l_status = YABMP_OK;
-	
-	assert(instance != NULL);
-	assert(value != NULL);
-	assert(instance->read_fn != NULL);
-
-	if (instance->read_fn(instance->stream_context, value, 1U) != 1U) {
-		l_status = YABMP_ERR_UNKNOW;
-	} else {
-		instance->stream_offset += 1U;
-	}
-	return l_status;
-}
-
-YABMP_UNUSED
-static yabmp_status yabmp_stream_read_le_16u(yabmp* instance, yabmp_uint16* value)
-{
-	yabmp_status l_status = YABMP_OK;
-	
-	assert(instance != NULL);
-	assert(value != NULL);
-	assert(instance->read_fn != NULL);
-	/* if we're on a little endian machine, just read directly */
-	if (instance->read_fn(instance->stream_context, value, 2U) != 2U) {
-		l_status = YABMP_ERR_UNKNOW;
-	} else {
-		instance->stream_offset += 2U;
-#if defined(YABMP_BIG_ENDIAN)
-		*value = yabmp_bswap16(*value);
-#endif
-	}
-	return l_status;
-}
-
-YABMP_UNUSED
-static yabmp_status yabmp_stream_read_le_32u(yabmp* instance, yabmp_uint32* value)
-{
-	yabmp_status l_status = YABMP_OK;
-	
-	assert(instance != NULL);
-	assert(value != NULL);
-	assert(instance->read_fn != NULL);
-	/* if we're on a little endian machine, just read directly */
-	if (instance->read_fn(instance->stream_context, value, 4U) != 4U) {
-		l_status = YABMP_ERR_UNKNOW;
-	} else {
-		instance->stream_offset += 4U;
-#if defined(YABMP_BIG_ENDIAN)
-		*value = yabmp_bswap32(*value);
-#endif
-	}
-	return l_status;
-}
-
 #endif /* YABMP_STREAM_H */
@@ -40,9 +40,20 @@
 #define YABMP_TRANSFORM_SCAN_ORDER 1U
 #define YABMP_TRANSFORM_EXPAND     2U
 #define YABMP_TRANSFORM_GRAYSCALE  4U
+#define YABMP_TRANSFORM_SCALE      8U
+#define YABMP_TRANSFORM_FILL_ALPHA 16U
 
 typedef void  (*yabmp_transform_fn)(const yabmp* instance, const void* pSrc, void* pDst );
 
+/* caller provided memory block, set with yabmp_create_reader_in_arena */
+typedef struct yabmp_arena_struct
+{
+	yabmp_uint8* base; /* first aligned byte */
+	size_t       size; /* usable bytes from base */
+	size_t       used; /* bytes allocated from base */
+	size_t       last; /* header offset of the last allocation, YABMP_ARENA_NONE when none can be reclaimed */
+} yabmp_arena;
+
 struct yabmp_struct
 {
 	yabmp_uint32        kind; /* YABMP_KIND_READER or YABMP_KIND_WRITER */
@@ -54,6 +65,7 @@ struct yabmp_struct
 	void* alloc_context; /* context passed to allocation functions */
 	yabmp_malloc_cb malloc_fn; /* user provided malloc function */
 	yabmp_free_cb   free_fn;   /* user provided free function */
+	yabmp_arena*    arena;     /* all allocations come from arena when not NULL */
 	
 	/* error management */
 	void* message_context; /* context passed to message functions */
@@ -67,7 +79,35 @@ struct yabmp_struct
 	yabmp_stream_seek_cb  seek_fn;  /* user provided stream seek function */
 	yabmp_stream_close_cb close_fn; /* user provided stream close function */
 	yabmp_uint32 stream_offset; /* current offset */
+	const yabmp_uint8* input_data; /* memory block when input was set with yabmp_set_input_memory, NULL otherwise */
+	size_t input_data_size; /* size of the input_data memory block */
 	
+	/* positional input, set with yabmp_set_input_stream_positional */
+	yabmp_stream_read_at_cb read_at_fn;       /* user provided positional read function, NULL otherwise */
+	yabmp_stream_close_cb   read_at_close_fn; /* user provided close function */
+	void*                   read_at_context;  /* context passed to read_at_fn & read_at_close_fn */
+	yabmp_uint32            read_at_offset;   /* offset of the next read_fn call */
+	
+	/* push input, set with yabmp_set_input_push */
+	yabmp_push_row_cb  push_row_fn;   /* user provided row function, NULL when not pushing */
+	yabmp_push_info_cb push_info_fn;  /* user provided info function */
+	void*              push_context;  /* context passed to push_row_fn & push_info_fn */
+	yabmp_info*        push_info;     /* user info filled before push_info_fn is called */
+	yabmp_uint8*       push_buffer;        /* pushed bytes not consumed yet */
+	size_t             push_buffer_size;   /* push_buffer capacity in bytes */
+	size_t             push_buffer_len;    /* valid bytes in push_buffer */
+	yabmp_uint32       push_buffer_offset; /* stream offset of the first byte in push_buffer */
+	void*              push_row;       /* row handed to push_row_fn */
+	size_t             push_row_size;  /* push_row capacity in bytes */
+	yabmp_uint32       push_row_count; /* number of rows handed to push_row_fn */
+	int                push_starved;   /* set when a decoding step ran out of pushed bytes */
+
+	/* read-ahead buffer */
+	yabmp_uint8* read_buffer;      /* read-ahead buffer, NULL when disabled */
+	size_t       read_buffer_size; /* read-ahead buffer capacity in bytes */
+	size_t       read_buffer_pos;  /* offset of stream_offset in read-ahead buffer */
+	size_t       read_buffer_len;  /* valid bytes in read-ahead buffer */
+
 	yabmp_uint32 status; /* what have we done ? */
 	yabmp_uint32 transforms; /* transformations that need to be done */
 	
@@ -79,13 +119,49 @@ struct yabmp_struct
 	yabmp_uint32 input_row_bytes;  /* input row size in bytes */
 	yabmp_uint32 input_step_bytes; /* input step size in bytes */
 	yabmp_uint32 transformed_row_bytes; /* transformed row size in bytes */
+	unsigned int row_alignment;         /* reported row size multiple set by yabmp_set_row_alignment, 0 when not set */
+	
+	/* region of interest, whole image when not set */
+	yabmp_uint32 region_x;      /* first column */
+	yabmp_uint32 region_y;      /* first row, in output order */
+	yabmp_uint32 region_width;  /* number of columns, pixels handed to transform_fn */
+	yabmp_uint32 region_height; /* number of rows */
+	yabmp_uint32 region_offset_bytes; /* offset of the first region byte in an uncompressed input row */
+	yabmp_uint32 region_row_bytes;    /* number of input bytes covering the region in an uncompressed input row */
+	unsigned int region_shift;        /* bit offset of the first region pixel in its byte */
 	
 	yabmp_transform_fn transform_fn;
+	yabmp_uint8*       expand_lut;      /* 1/2/4bpp palette expansion table, expanded pixels for each source byte value, or RLE run patterns */
+	size_t             expand_lut_size; /* expand_lut capacity in bytes, kept by yabmp_reset_reader */
+	unsigned int       output_format;   /* YABMP_OUTPUT_* flags set by yabmp_set_output_format */
+	yabmp_uint32       out_mask[4];     /* bitfield masks in output channel order, computed once by local_setup_read */
+	unsigned int       out_shift[4];    /* bitfield mask shifts in output channel order */
+	yabmp_uint32       out_fill[4];     /* or'ed into samples in output channel order, opaque alpha when filled */
+	int                out_swap16;      /* 16 bits samples are byte swapped */
+	const void*        scale_lut[4];    /* full range tables in output channel order inside scale_lut_buffer, set by local_setup_scale */
+	void*              scale_lut_buffer;
+	size_t             scale_lut_size;  /* scale_lut_buffer capacity in bytes, kept by yabmp_reset_reader */
+	yabmp_uint32       palette_packed[256]; /* palette packed in output channel order, see yabmp_prepare_palette_packed */
+	yabmp_uint8        palette_gray[256];   /* gray level of each palette entry, see yabmp_prepare_palette_gray */
+	yabmp_uint32       luma_weights[3];     /* blue, green & red weights summing to 32768 set by yabmp_set_rgb_to_gray, all 0 otherwise */
+	yabmp_uint32       luma_lut[3][256];    /* weighted full range blue, green & red bitfield samples, see local_setup_luma */
 	void*              input_row;
+	size_t             input_row_size; /* input_row capacity in bytes, kept by yabmp_reset_reader */
 	
 	yabmp_uint8* rle_row;
+	size_t       rle_row_size; /* rle_row capacity in bytes, kept by yabmp_reset_reader */
 	unsigned int rle_skip_x;
 	unsigned int rle_skip_y;
+	unsigned int rle_expand_bytes; /* bytes per pixel written by local_rle_expand_row, 0 when RLE rows are decoded to indices */
+	
+	/* parallel decoding */
+	unsigned int          task_count;       /* number of bands decoded in parallel by yabmp_read_image, 0 or 1 when disabled */
+	yabmp_parallel_for_cb parallel_fn;      /* user provided parallel-for function, NULL to use internal threads */
+	void*                 parallel_context; /* context passed to parallel_fn */
+	
+	/* RLE row index */
+	yabmp_uint32* row_index; /* YABMP_ROW_INDEX_VALUES_PER_ROW values per row in stream order, NULL when not built */
+	yabmp_uint32  next_row;  /* next row to read in stream order, only tracked with row_index */
 };
 
 YABMP_IAPI(void, yabmp_init_version, (yabmp* instance));
@@ -60,6 +60,19 @@
 #define YABMP_COMPRESSION_RLE8 1U /**< Image data is compressed using RLE8 algorithm. */
 #define YABMP_COMPRESSION_RLE4 2U /**< Image data is compressed using RLE4 algorithm. */
 
+#define YABMP_OUTPUT_BGR         0U /**< Blue, green, red then alpha channels, 16 bits samples in host byte order. This is the default. */
+#define YABMP_OUTPUT_RGB         1U /**< Red, green, blue channel order. */
+#define YABMP_OUTPUT_ALPHA_FIRST 2U /**< Alpha channel before color channels. */
+#define YABMP_OUTPUT_BIG_ENDIAN  4U /**< 16 bits samples in big endian byte order. */
+
+#define YABMP_LUMA_BT601 0U /**< ITU-R BT.601 luma weights: 0.299 red, 0.587 green, 0.114 blue. */
+#define YABMP_LUMA_BT709 1U /**< ITU-R BT.709 luma weights: 0.2126 red, 0.7152 green, 0.0722 blue. */
+
+#define YABMP_MEMORY_ROW_INDEX 1U /**< Account for a row index in #yabmp_query_memory_requirements. */
+#define YABMP_MEMORY_SCALE     2U /**< Account for #yabmp_set_scale_to_full_range tables in #yabmp_query_memory_requirements. */
+
+#define YABMP_ROW_INDEX_VALUES_PER_ROW 3U /**< Number of values per row in a row index: stream offset, RLE horizontal skip, RLE vertical skip. */
+
 #define YABMP_COLOR_PROFILE_NONE           0U /**< Image has no color profile. */
 #define YABMP_COLOR_PROFILE_sRGB           1U /**< Image has sRGB color profile. */
 #define YABMP_COLOR_PROFILE_ICC_LINKED     2U /**< Image has a linked ICC profile. */
@@ -92,6 +105,20 @@ typedef struct yabmp_struct      yabmp;
  */
 typedef struct yabmp_info_struct yabmp_info;
 		
+/**
+ * Basic image information reported by #yabmp_probe.
+ */
+typedef struct yabmp_probe_result_struct
+{
+	yabmp_uint32 width;          /**< Image width in pixels. */
+	yabmp_uint32 height;         /**< Image height in pixels. */
+	unsigned int bpp;            /**< Number of bits per pixel. */
+	unsigned int compression;    /**< Compression type (see #yabmp_get_compression_type). */
+	unsigned int scan_direction; /**< Scan direction (see #yabmp_get_scan_direction). */
+	yabmp_uint32 data_offset;    /**< Offset of image data from the beginning of the stream in bytes. */
+	size_t       missing_bytes;  /**< Number of bytes missing from the probed data, other fields are only valid when 0. */
+} yabmp_probe_result;
+		
 /**
  * Palette color.
  */
@@ -112,6 +139,48 @@ typedef struct yabmp_cie_xyz_struct
 	yabmp_q2d30 z;
 } yabmp_cie_xyz;
 		
+/**
+ * Image header description filled by #yabmp_get_header_desc.
+ *
+ * struct_size must be set to sizeof(yabmp_header_desc) before calling #yabmp_get_header_desc.
+ * Fields will only ever be appended to this structure.
+ * Only the first struct_size bytes are written, fields unknown to the library are left untouched.
+ */
+typedef struct yabmp_header_desc_struct
+{
+	size_t             struct_size;           /**< Size of this structure in bytes, set by the caller. */
+	yabmp_uint32       width;                 /**< Image width in pixels (see #yabmp_get_dimensions). */
+	yabmp_uint32       height;                /**< Image height in pixels (see #yabmp_get_dimensions). */
+	yabmp_uint32       res_ppm_x;             /**< Resolution along the X-axis (see #yabmp_get_pixels_per_meter). */
+	yabmp_uint32       res_ppm_y;             /**< Resolution along the Y-axis (see #yabmp_get_pixels_per_meter). */
+	unsigned int       bit_depth;             /**< Sample bit depth (see #yabmp_get_bit_depth). */
+	unsigned int       color_type;            /**< Image color type (see #yabmp_get_color_type). */
+	yabmp_uint32       compression;           /**< Image compression type (see #yabmp_get_compression_type). */
+	unsigned int       scan_direction;        /**< Image scan direction (see #yabmp_get_scan_direction). */
+	yabmp_uint32       blue_mask;             /**< Blue channel bit-mask, 0 without bitfields. */
+	yabmp_uint32       green_mask;            /**< Green channel bit-mask, 0 without bitfields. */
+	yabmp_uint32       red_mask;              /**< Red channel bit-mask, 0 without bitfields. */
+	yabmp_uint32       alpha_mask;            /**< Alpha channel bit-mask, 0 without bitfields. */
+	unsigned int       blue_bits;             /**< Blue channel bit depth (see #yabmp_get_bits). */
+	unsigned int       green_bits;            /**< Green channel bit depth (see #yabmp_get_bits). */
+	unsigned int       red_bits;              /**< Red channel bit depth (see #yabmp_get_bits). */
+	unsigned int       alpha_bits;            /**< Alpha channel bit depth (see #yabmp_get_bits). */
+	unsigned int       palette_count;         /**< Number of palette entries, 0 without palette. */
+	yabmp_color const* palette;               /**< Palette, NULL without palette. Owned by the info object. */
+	unsigned int       color_profile_type;    /**< Color profile type. */
+	unsigned int       color_profile_intent;  /**< Color profile intent. */
+	yabmp_uint8 const* icc_profile;           /**< ICC profile data, NULL without ICC profile. Owned by the info object. */
+	yabmp_uint32       icc_profile_len;       /**< ICC profile size in bytes, 0 without ICC profile. */
+	yabmp_cie_xyz      cie_r;                 /**< Red end point, calibrated RGB only. */
+	yabmp_cie_xyz      cie_g;                 /**< Green end point, calibrated RGB only. */
+	yabmp_cie_xyz      cie_b;                 /**< Blue end point, calibrated RGB only. */
+	yabmp_q16d16       gamma_r;               /**< Red gamma, calibrated RGB only. */
+	yabmp_q16d16       gamma_g;               /**< Green gamma, calibrated RGB only. */
+	yabmp_q16d16       gamma_b;               /**< Blue gamma, calibrated RGB only. */
+	size_t             row_bytes;             /**< Row size in bytes for info (see #yabmp_get_rowbytes). */
+	size_t             transformed_row_bytes; /**< Row size in bytes of rows returned by #yabmp_read_row with the transforms currently set. */
+} yabmp_header_desc;
+		
 /**
  * Callback function prototype for messages
  * @param[in] context User message context provided in #yabmp_create_reader.
@@ -175,6 +244,18 @@ typedef size_t (*yabmp_stream_write_cb)(void* context, const void * ptr, size_t
  *   yabmp_set_output_stream
  */
 typedef yabmp_status (*yabmp_stream_seek_cb) (void* context, yabmp_uint32 offset);
+/**
+ * Callback function prototype for positional stream reading
+ * @param[in] context User stream context provided in #yabmp_set_input_stream_positional.
+ * @param[in] offset  Offset from beginning of stream in bytes at which to start reading.
+ * @param[in] ptr     Pointer to a memory block where data shall be copied.
+ * @param[in] size    Number of bytes to be copied.
+ * @return Number of bytes read from the input stream.
+ *
+ * @see
+ *   yabmp_set_input_stream_positional
+ */
+typedef size_t (*yabmp_stream_read_at_cb)(void* context, yabmp_uint32 offset, void * ptr, size_t size);
 		
 /**
  * Callback function prototype to close a stream
@@ -185,6 +266,51 @@ typedef yabmp_status (*yabmp_stream_seek_cb) (void* context, yabmp_uint32 offset
  *   yabmp_set_output_stream
  */
 typedef void (*yabmp_stream_close_cb) (void* context);
+/**
+ * Task function, runs one task out of those given to #yabmp_parallel_for_cb.
+ *
+ * @param[in] context    Task context provided to #yabmp_parallel_for_cb.
+ * @param[in] task_index Index of the task to run.
+ */
+typedef void (*yabmp_task_cb)(void* context, unsigned int task_index);
+/**
+ * Parallel-for function, runs \a task_fn for every task index in [0, \a task_count), possibly concurrently.
+ * It must return once all tasks are done.
+ *
+ * @param[in] context      User parallel context provided in #yabmp_set_decode_threads.
+ * @param[in] task_count   Number of tasks to run.
+ * @param[in] task_fn      Task function.
+ * @param[in] task_context Context to pass to \a task_fn.
+ *
+ * @see
+ *   yabmp_set_decode_threads
+ */
+typedef void (*yabmp_parallel_for_cb)(void* context, unsigned int task_count, yabmp_task_cb task_fn, void* task_context);
+/**
+ * Callback function prototype called by #yabmp_push_data once info are available.
+ * Transformations & region can be set from this callback.
+ *
+ * @param[in] context User push context provided in #yabmp_set_input_push.
+ * @param[in] reader  Pointer to the reader object.
+ * @param[in] info    Pointer to the information object provided in #yabmp_set_input_push.
+ * @return #YABMP_OK to go on decoding, any other value is returned by #yabmp_push_data.
+ *
+ * @see
+ *   yabmp_set_input_push
+ */
+typedef yabmp_status (*yabmp_push_info_cb)(void* context, yabmp* reader, yabmp_info* info);
+/**
+ * Callback function prototype called by #yabmp_push_data for every decoded row.
+ *
+ * @param[in] context   User push context provided in #yabmp_set_input_push.
+ * @param[in] row_index Index of the row in reading order (see #yabmp_get_scan_direction).
+ * @param[in] row       Pointer to the decoded row, only valid during the call.
+ * @return #YABMP_OK to go on decoding, any other value is returned by #yabmp_push_data.
+ *
+ * @see
+ *   yabmp_set_input_push
+ */
+typedef yabmp_status (*yabmp_push_row_cb)(void* context, yabmp_uint32 row_index, const void* row);
 		
 /**
  * Gets library version components as integers.
@@ -234,6 +360,58 @@ YABMP_API(yabmp_status, yabmp_create_reader, (
 	yabmp_free_cb free_fn
 ));
 		
+/**
+ * Creates a BMP reader allocating memory only from a caller provided block.
+ *
+ * The reader, info objects created for it and all internal buffers are taken from \a buffer.
+ * Memory is never given back to an allocator, the whole \a buffer can be discarded once the reader is destroyed.
+ *
+ * @param[out] reader          Pointer to the reader object.
+ * @param[in]  message_context User context that will be provided to \a error_fn & \a warning_fn when called.
+ * @param[in]  error_fn        Message callback that will be called on error. Optional, can be NULL.
+ * @param[in]  warning_fn      Message callback that will be called on warning. Optional, can be NULL.
+ * @param[in]  buffer          Memory block used for all allocations. It must remain valid until the reader is destroyed.
+ * @param[in]  buffer_size     Size of the \a buffer in bytes.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION when \a buffer is too small.
+ *
+ * @remarks
+ *   An ICC profile that doesn't fit in the remaining memory is ignored with a warning.
+ *
+ * @see
+ *   yabmp_query_memory_requirements
+ *
+ */
+YABMP_API(yabmp_status, yabmp_create_reader_in_arena, (
+	yabmp** reader,
+	void* message_context,
+	yabmp_message_cb error_fn,
+	yabmp_message_cb warning_fn,
+	void* buffer,
+	size_t buffer_size
+));
+
+/**
+ * Gets the memory block size needed by #yabmp_create_reader_in_arena to decode an image.
+ *
+ * This accounts for the reader, one info object and row buffers needed by any transformation or region.
+ * The read-ahead buffer size, push input, decoding threads and ICC profile are not accounted for.
+ *
+ * @param[in]  probe Pointer to the image probe result (see #yabmp_probe).
+ * @param[in]  flags Additional features that will be used (#YABMP_MEMORY_ROW_INDEX, #YABMP_MEMORY_SCALE), 0 if none.
+ * @param[out] size  Required size in bytes.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_UNKNOW when the required size can't be represented.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_query_memory_requirements, (const yabmp_probe_result* probe, unsigned int flags, size_t* size));
+		
 /**
  * Destroys a BMP reader.
  *
@@ -243,6 +421,22 @@ YABMP_API(yabmp_status, yabmp_create_reader, (
  */
 YABMP_API(void, yabmp_destroy_reader, (yabmp** reader, yabmp_info** info));
 
+/**
+ * Resets a BMP reader so that it can read another image.
+ *
+ * The input stream is closed, info, transformations and region are cleared.
+ * Allocation & message callbacks, read-ahead buffer size and decoding threads are kept.
+ * Internal buffers are kept and only grown when needed by the next image.
+ *
+ * @param[in, out] reader Pointer to the reader object.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_reset_reader, (yabmp* reader));
+
 /**
  * Sets input stream.
  *
@@ -257,7 +451,7 @@ YABMP_API(void, yabmp_destroy_reader, (yabmp** reader, yabmp_info** info));
  * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
  *
  * @remarks
- *   If \a seek_fn is NULL, it won't be possible to use #yabmp_set_invert_scan_direction.
+ *   If \a seek_fn is NULL, it won't be possible to read rows one by one after #yabmp_set_invert_scan_direction. #yabmp_read_image can still be used.
  *
  */
 YABMP_API(yabmp_status, yabmp_set_input_stream, (
@@ -267,6 +461,80 @@ YABMP_API(yabmp_status, yabmp_set_input_stream, (
 	yabmp_stream_seek_cb  seek_fn,
 	yabmp_stream_close_cb close_fn
 ));
+
+/**
+ * Sets positional input stream.
+ *
+ * Every read explicitly gives its offset (e.g. pread), seeking never calls back into the user stream.
+ *
+ * @param[in]  reader         Pointer to the reader object.
+ * @param[in]  stream_context User context that will be provided to \a read_at_fn & \a close_fn when called.
+ * @param[in]  read_at_fn     Callback that will be called to read data from input stream.
+ * @param[in]  close_fn       Callback that will be called to close the input stream. Optional, can be NULL.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ * @remarks
+ *   When decoding threads are set with #yabmp_set_decode_threads, \a read_at_fn might be called concurrently.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_input_stream_positional, (
+	yabmp* reader,
+	void* stream_context,
+	yabmp_stream_read_at_cb read_at_fn,
+	yabmp_stream_close_cb   close_fn
+));
+
+/**
+ * Sets push input.
+ *
+ * Data is then given with #yabmp_push_data as it arrives.
+ * \a info_fn is called once info are available, \a row_fn is called for every row as soon as enough data was pushed.
+ *
+ * @param[in]  reader       Pointer to the reader object.
+ * @param[in]  info         Pointer to the information object filled before \a info_fn is called.
+ * @param[in]  push_context User context that will be provided to \a info_fn & \a row_fn when called.
+ * @param[in]  info_fn      Callback that will be called once info are available. Optional, can be NULL.
+ * @param[in]  row_fn       Callback that will be called for every decoded row.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ * @remarks
+ *   There is no seek function, rows are decoded in stream order and #yabmp_set_invert_scan_direction can't be used.\n
+ *   Pushed bytes are held until they are parsed: headers, bitfields & palette (about 1 KiB at most) until info are available,
+ *   then the bytes of the row being decoded. Bytes between headers & image data are dropped as they arrive.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_input_push, (
+	yabmp* reader,
+	yabmp_info* info,
+	void* push_context,
+	yabmp_push_info_cb info_fn,
+	yabmp_push_row_cb  row_fn
+));
+
+/**
+ * Pushes input data.
+ *
+ * Decodes as much as possible from the data pushed so far, calling back the functions provided in #yabmp_set_input_push.
+ * Data pushed once all rows were decoded is ignored.
+ *
+ * @param[in]  reader    Pointer to the reader object.
+ * @param[in]  data      Pointer to the next bytes of the input stream.
+ * @param[in]  data_size Size of the \a data block in bytes.
+ *
+ * @return
+ * #YABMP_OK on success, even when more data is needed.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW on invalid data.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_push_data, (yabmp* reader, const void* data, size_t data_size));
 		
 /**
  * Sets input file.
@@ -286,7 +554,34 @@ YABMP_API(yabmp_status, yabmp_set_input_file, (
 ));
 		
 /**
- * Sets input file.
+ * Sets input file, mapped in memory.
+ *
+ * The file is mapped in memory when the platform supports it, avoiding copies through stdio buffers.
+ * If the file can't be mapped, this falls back to #yabmp_set_input_file.
+ * When the file is mapped, #yabmp_read_row_ref can be used.
+ *
+ * @param[in]  reader Pointer to the reader object.
+ * @param[in]  path   Path to the file to be opened.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_UNKNOW if the file can't be opened.
+ *
+ * @see
+ *   yabmp_set_input_file\n
+ *   yabmp_read_row_ref
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_input_file_mmap, (
+	yabmp* reader,
+	const char* path
+));
+
+/**
+ * Sets input memory block.
+ *
+ * The \a data block must remain valid until the reader is destroyed.
  *
  * @param[in]  reader    Pointer to the reader object.
  * @param[in]  data      Pointer to the data block used for reading.
@@ -294,12 +589,38 @@ YABMP_API(yabmp_status, yabmp_set_input_file, (
  *
  * @return
  * #YABMP_OK on success.\n
- * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
- * #YABMP_ERR_ALLOCATION on allocation failure.
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ * @see
+ *   yabmp_read_row_ref
  *
  */
 YABMP_API(yabmp_status, yabmp_set_input_memory, (yabmp* reader, const void* data, size_t data_size));
 
+/**
+ * Sets the size of the read-ahead buffer.
+ *
+ * When \a buffer_size is not 0, data is read from the input stream in chunks of at least \a buffer_size bytes
+ * and small reads (headers, palette, RLE opcodes...) are served from memory.
+ * This reduces the number of calls to the read function provided in #yabmp_set_input_stream.
+ * Data might be read from the input stream before it's actually needed.
+ * The read-ahead buffer is disabled by default. RLE compressed data read from a stream uses a 4 KiB buffer when none was set.
+ *
+ * @param[in]  reader      Pointer to the reader object.
+ * @param[in]  buffer_size Size of the read-ahead buffer in bytes. 0 disables the read-ahead buffer.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW when data already buffered can't be kept (no seek function).
+ *
+ * @see
+ *   yabmp_set_input_stream
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_read_buffer_size, (yabmp* reader, size_t buffer_size));
+
 /**
  * Creates an information object.
  *
@@ -334,6 +655,27 @@ YABMP_API(yabmp_status, yabmp_create_info, (yabmp* instance, yabmp_info ** info)
  */
 YABMP_API(yabmp_status, yabmp_read_info, (yabmp* reader, yabmp_info * info));
 
+/**
+ * Probes basic image information from the beginning of a BMP stream.
+ *
+ * Only the file header and the start of the DIB header are parsed, without any allocation or callback.
+ * When \a data_size is too small, #YABMP_OK is returned with \a result missing_bytes set to the number of bytes to add.
+ *
+ * @param[in]  data      Pointer to the first bytes of the stream. Can be NULL only if \a data_size is 0.
+ * @param[in]  data_size Size of the \a data block in bytes.
+ * @param[out] result    Pointer to the probe result.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_UNKNOW when \a data is not a supported BMP stream.
+ *
+ * @remarks
+ *   Full validation is only done by #yabmp_read_info, this function might succeed on some invalid streams.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_probe, (const void* data, size_t data_size, yabmp_probe_result* result));
+
 /**
  * Reads a row of image data from the input stream.
  *
@@ -358,6 +700,200 @@ YABMP_API(yabmp_status, yabmp_read_info, (yabmp* reader, yabmp_info * info));
  */
 YABMP_API(yabmp_status, yabmp_read_row, (yabmp* reader, void* row, size_t row_size));
 
+/**
+ * Reads one arbitrary row of image data from the input stream.
+ *
+ * The row position is computed from its index, no other row is decoded. Scan direction, region and transforms are honored,
+ * \a row_index 0 being the first row #yabmp_read_row would return. A following call to #yabmp_read_row reads row \a row_index + 1.
+ * This requires a seek function and is only supported for #YABMP_COMPRESSION_NONE compression type or when a row index is set.
+ *
+ * @param[in]  reader    Pointer to the reader object.
+ * @param[in]  row_index Index of the row to read.
+ * @param[in]  row       Pointer to the buffer that will receive image data.
+ * @param[in]  row_size  Size of the \a row buffer in bytes.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided or \a row_index is out of range.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW in other failure cases.
+ *
+ * @see
+ *   yabmp_read_row\n
+ *   yabmp_set_read_region\n
+ *   yabmp_build_row_index
+ *
+ */
+YABMP_API(yabmp_status, yabmp_read_row_at, (yabmp* reader, yabmp_uint32 row_index, void* row, size_t row_size));
+
+/**
+ * Reads several rows of image data from the input stream.
+ *
+ * This is equivalent to calling #yabmp_read_row \a count times but avoids per row overhead.
+ * When the destination layout matches the input stream layout (\a stride equal to the 4 bytes aligned input row size and no transforms),
+ * all rows are read with a single stream request.
+ * When scan direction is inverted, rows are read forward with a single seek.
+ *
+ * @param[in]  reader Pointer to the reader object.
+ * @param[in]  rows   Pointer to the buffer that will receive image data. Its size must be at least (\a count - 1) * \a stride + row size.
+ * @param[in]  stride Offset in bytes between the start of two consecutive rows in \a rows.
+ * @param[in]  count  Number of rows to read.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW in other failure cases.
+ *
+ * @see
+ *   yabmp_read_row\n
+ *   yabmp_get_rowbytes
+ *
+ */
+YABMP_API(yabmp_status, yabmp_read_rows, (yabmp* reader, void* rows, size_t stride, yabmp_uint32 count));
+
+/**
+ * Reads the whole image from the input stream.
+ *
+ * The input stream is always read forward. When the scan direction is inverted, rows are stored
+ * starting from the last one in \a image. This works without a seek function and for compressed images.
+ * Rows are decoded in parallel when enabled with #yabmp_set_decode_threads.
+ * This function must be called before any row is read.
+ *
+ * @param[in]  reader Pointer to the reader object.
+ * @param[in]  image  Pointer to the buffer that will receive image data. Its size must be at least (height - 1) * \a stride + row size.
+ * @param[in]  stride Offset in bytes between the start of two consecutive rows in \a image.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW in other failure cases.
+ *
+ * @see
+ *   yabmp_read_rows\n
+ *   yabmp_set_invert_scan_direction\n
+ *   yabmp_set_decode_threads
+ *
+ */
+YABMP_API(yabmp_status, yabmp_read_image, (yabmp* reader, void* image, size_t stride));
+
+/**
+ * Enables parallel decoding in #yabmp_read_image.
+ *
+ * The image is split in \a thread_count bands of rows decoded concurrently. This is only used for #YABMP_COMPRESSION_NONE images
+ * when input was set using #yabmp_set_input_memory (or a mapped #yabmp_set_input_file_mmap) or #yabmp_set_input_stream_positional,
+ * #yabmp_read_image falls back to sequential decoding otherwise. With positional input, \a read_at_fn is then called concurrently
+ * (see #yabmp_set_input_stream_positional).
+ * When \a parallel_fn is NULL, the library runs bands on its own threads if available on the platform.
+ *
+ * @param[in]  reader           Pointer to the reader object.
+ * @param[in]  thread_count     Number of bands, 0 or 1 disables parallel decoding.
+ * @param[in]  parallel_context User parallel context passed to \a parallel_fn.
+ * @param[in]  parallel_fn      User parallel-for function, can be NULL.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ * @see
+ *   yabmp_read_image\n
+ *   yabmp_set_input_stream_positional
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_decode_threads, (yabmp* reader, unsigned int thread_count, void* parallel_context, yabmp_parallel_for_cb parallel_fn));
+
+/**
+ * Gets a pointer to the next row of image data, without copying it.
+ *
+ * This is only possible when input was set using #yabmp_set_input_memory (or a mapped #yabmp_set_input_file_mmap), the image
+ * is not compressed and no transform other than #yabmp_set_invert_scan_direction is used.
+ * The returned pointer points into the memory block provided to #yabmp_set_input_memory.
+ * It can be used in place of #yabmp_read_row.
+ * The row is generally not aligned for 16 or 32 bits samples (it depends on the block address & image data offset):
+ * read samples bytewise or copy them with memcpy rather than casting the pointer to a 16 or 32 bits type.
+ *
+ * @param[in]  reader Pointer to the reader object.
+ * @param[out] row    Pointer to the row of image data.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW when the row can't be referenced or in other failure cases.
+ *
+ * @see
+ *   yabmp_read_row\n
+ *   yabmp_set_input_memory
+ *
+ */
+YABMP_API(yabmp_status, yabmp_read_row_ref, (yabmp* reader, const void** row));
+
+/**
+ * Builds a row index for RLE compressed images.
+ *
+ * The whole image data is gone through once without decoding pixels. The stream offset and decoder state are recorded at the start of each row.
+ * Once built, rows can be read in any order with #yabmp_read_row_at and scan direction can be inverted when reading rows.
+ * This requires a seek function and must be called after #yabmp_read_info and before any row is read.
+ *
+ * @param[in]  reader Pointer to the reader object.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW when compression type is not #YABMP_COMPRESSION_RLE4 or #YABMP_COMPRESSION_RLE8 or in other failure cases.
+ *
+ * @see
+ *   yabmp_get_row_index\n
+ *   yabmp_set_row_index
+ *
+ */
+YABMP_API(yabmp_status, yabmp_build_row_index, (yabmp* reader));
+
+/**
+ * Gets the row index of the image.
+ *
+ * The index holds #YABMP_ROW_INDEX_VALUES_PER_ROW values per row, in stream order. It can be persisted and given back to #yabmp_set_row_index for the same image.
+ * The returned pointer remains valid until the reader is destroyed or the row index is changed.
+ *
+ * @param[in]  reader    Pointer to the reader object.
+ * @param[out] index     Pointer to the row index.
+ * @param[out] index_len Number of values in \a index.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
+ * #YABMP_ERR_UNKNOW when no row index is set.
+ *
+ * @see
+ *   yabmp_build_row_index
+ *
+ */
+YABMP_API(yabmp_status, yabmp_get_row_index, (const yabmp* reader, const yabmp_uint32** index, size_t* index_len));
+
+/**
+ * Sets a row index previously retrieved with #yabmp_get_row_index.
+ *
+ * The index is copied. It must have been built for the same image.
+ * This requires a seek function and must be called after #yabmp_read_info and before any row is read.
+ *
+ * @param[in]  reader    Pointer to the reader object.
+ * @param[in]  index     Pointer to the row index.
+ * @param[in]  index_len Number of values in \a index.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided or \a index doesn't match the image.\n
+ * #YABMP_ERR_ALLOCATION on allocation failure.\n
+ * #YABMP_ERR_UNKNOW when compression type is not #YABMP_COMPRESSION_RLE4 or #YABMP_COMPRESSION_RLE8 or in other failure cases.
+ *
+ * @see
+ *   yabmp_build_row_index
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_row_index, (yabmp* reader, const yabmp_uint32* index, size_t index_len));
+
 /**
  * Gets width & height of the image.
  *
@@ -522,26 +1058,44 @@ YABMP_API(yabmp_status, yabmp_get_color_profile_calibration, (const yabmp* insta
  *
  */
 YABMP_API(yabmp_status, yabmp_get_rowbytes, (const yabmp* instance, const yabmp_info* info, size_t* row_bytes));
+		
+/**
+ * Gets all image information at once.
+ *
+ * Fills desc with what individual getters would return for info.
+ * transformed_row_bytes takes into account transforms & region currently set on reader.
+ *
+ * @param[in]     reader Pointer to the reader object.
+ * @param[in]     info   Pointer to the info object.
+ * @param[in,out] desc   Description to fill. desc->struct_size must be set by the caller and is left unchanged.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided or desc->struct_size is too small.\n
+ *
+ */
+YABMP_API(yabmp_status, yabmp_get_header_desc, (const yabmp* reader, const yabmp_info* info, yabmp_header_desc* desc));
 YABMP_API(yabmp_status, yabmp_read_update_info, (const yabmp* reader, yabmp_info* info));
 		
 /**
  * Invert scan direction.
  *
  * Image rows will be read in the opposite direction as what's reported by #yabmp_get_scan_direction.
- * This requires a seek function to be set when calling #yabmp_set_input_stream.
- * Inverting scan direction is only supported for #YABMP_COMPRESSION_NONE compression type.
+ * Reading rows one by one then requires a seek function to be set when calling #yabmp_set_input_stream
+ * and is only supported for #YABMP_COMPRESSION_NONE compression type unless a row index is set (an error is reported when reading starts).
+ * #yabmp_read_image has none of those restrictions.
  *
  * @param[in]  instance Pointer to the reader object.
  *
  * @return
  * #YABMP_OK on success.\n
- * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.\n
- * #YABMP_ERR_UNKNOW when no seek function is set or compression type is not #YABMP_COMPRESSION_NONE.
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
  *
  * @see
  *   yabmp_get_scan_direction\n
  *   yabmp_get_compression_type\n
- *   yabmp_set_input_stream
+ *   yabmp_set_input_stream\n
+ *   yabmp_read_image
  *
  */
 YABMP_API(yabmp_status, yabmp_set_invert_scan_direction, (yabmp* instance));
@@ -558,6 +1112,25 @@ YABMP_API(yabmp_status, yabmp_set_invert_scan_direction, (yabmp* instance));
  *
  */
 YABMP_API(yabmp_status, yabmp_set_expand_to_bgrx, (yabmp* instance));
+/**
+ * Expand to BGRA.
+ *
+ * Image rows will be read in BGRA format, including 24bpp images.
+ * An opaque alpha channel (all bits set) is added to images without alpha channel so that every pixel
+ * is stored on 4 samples, i.e. a 32 bits word for 8 bits samples.
+ *
+ * @param[in]  instance Pointer to the reader object.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ * @see
+ *   yabmp_set_expand_to_bgrx\n
+ *   yabmp_set_output_format
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_expand_to_bgra, (yabmp* instance));
 /**
  * Expand to grayscale.
  *
@@ -572,6 +1145,99 @@ YABMP_API(yabmp_status, yabmp_set_expand_to_bgrx, (yabmp* instance));
  *
  */
 YABMP_API(yabmp_status, yabmp_set_expand_to_grayscale, (yabmp* instance));
+/**
+ * Convert color to grayscale.
+ *
+ * Image rows will be read in Y8 format, each pixel being the weighted sum of its red, green & blue samples (15 bits fixed point).
+ * This transform works with palette, 24bpp & bitfields images with channel depth <= 8. Bitfield samples are scaled to full range first.
+ * Alpha channel is dropped.
+ *
+ * @param[in]  instance Pointer to the reader object.
+ * @param[in]  weights  #YABMP_LUMA_BT601 or #YABMP_LUMA_BT709.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ * @see
+ *   yabmp_set_expand_to_grayscale
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_rgb_to_gray, (yabmp* instance, unsigned int weights));
+/**
+ * Scale samples to full range.
+ *
+ * Bitfield samples expanded with #yabmp_set_expand_to_bgrx will be scaled to the full 8 or 16 bits range by bit replication
+ * instead of being returned in their low bits. #yabmp_get_bits still reports the number of significant bits.
+ * This transform has no effect on other images.
+ *
+ * @param[in]  instance Pointer to the reader object.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_scale_to_full_range, (yabmp* instance));
+/**
+ * Set output channel order & sample byte order.
+ *
+ * Applies to color rows: 24bpp images & images expanded with #yabmp_set_expand_to_bgrx or #yabmp_set_expand_to_bgra.
+ * Channels are written directly in the requested layout, e.g. #YABMP_OUTPUT_RGB gives RGB or RGBA rows,
+ * #YABMP_OUTPUT_RGB | #YABMP_OUTPUT_ALPHA_FIRST gives RGB or ARGB rows.\n
+ * #YABMP_OUTPUT_ALPHA_FIRST has no effect without alpha channel, #YABMP_OUTPUT_BIG_ENDIAN has no effect on 8 bits samples.\n
+ * Color type & bitfields reported for the image are not affected.
+ *
+ * @param[in]  instance Pointer to the reader object.
+ * @param[in]  format   #YABMP_OUTPUT_BGR or a combination of #YABMP_OUTPUT_RGB, #YABMP_OUTPUT_ALPHA_FIRST & #YABMP_OUTPUT_BIG_ENDIAN.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_output_format, (yabmp* instance, unsigned int format));
+/**
+ * Sets row alignment.
+ *
+ * Row size reported by #yabmp_read_update_info & #yabmp_get_header_desc is rounded up to a multiple of \a alignment bytes.
+ * Using that size as stride for #yabmp_read_image or #yabmp_read_rows keeps every row aligned like the first one.
+ * Padding bytes at the end of rows are not written. Rows are not aligned by default.
+ *
+ * @param[in]  reader    Pointer to the reader object.
+ * @param[in]  alignment Row alignment in bytes, a power of 2 up to 256. 1 disables alignment.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided.
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_row_alignment, (yabmp* reader, unsigned int alignment));
+/**
+ * Restrict reading to a region of the image.
+ *
+ * Only \a height rows of \a width pixels, starting at column \a x and row \a y, will be read. Rows are counted in reading order,
+ * i.e. after #yabmp_set_invert_scan_direction is applied. #yabmp_read_update_info reports the region dimensions.
+ * Rows above the region are skipped without being decoded, columns outside the region are not read for uncompressed images.
+ * This function must be called after #yabmp_read_info and before any row is read.
+ *
+ * @param[in]  reader Pointer to the reader object.
+ * @param[in]  x      First column of the region.
+ * @param[in]  y      First row of the region.
+ * @param[in]  width  Width of the region in pixels.
+ * @param[in]  height Height of the region in pixels.
+ *
+ * @return
+ * #YABMP_OK on success.\n
+ * #YABMP_ERR_INVALID_ARGS when invalid arguments are provided or the region doesn't fit in the image.\n
+ * #YABMP_ERR_UNKNOW in other failure cases.
+ *
+ * @see
+ *   yabmp_read_info\n
+ *   yabmp_read_update_info
+ *
+ */
+YABMP_API(yabmp_status, yabmp_set_read_region, (yabmp* reader, yabmp_uint32 x, yabmp_uint32 y, yabmp_uint32 width, yabmp_uint32 height));
 		
 #ifdef __cplusplus
 	}
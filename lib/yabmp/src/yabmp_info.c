@@ -22,8 +22,65 @@
  * SOFTWARE.
  */
 
+#include <stddef.h>
 #include "../inc/private/yabmp_internal.h"
 
+/* yabmp_header_desc fields are only appended, callers built against the first version are still served */
+#define YABMP_HEADER_DESC_V1_SIZE (offsetof(yabmp_header_desc, transformed_row_bytes) + sizeof(size_t))
+
+static unsigned int local_bit_depth(const yabmp_info* info)
+{
+	/* For now modify this here... */
+	switch ((info->flags>> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK) {
+		case YABMP_COLOR_TYPE_BGR:
+			return info->bpp / 3U;
+		case YABMP_COLOR_TYPE_BGR_ALPHA:
+			return info->bpp / 4U;
+		case YABMP_COLOR_TYPE_GRAY:
+		case YABMP_COLOR_TYPE_PALETTE:
+		case YABMP_COLOR_TYPE_GRAY_PALETTE:
+		case YABMP_COLOR_TYPE_BITFIELDS:
+		case YABMP_COLOR_TYPE_BITFIELDS_ALPHA:
+		default:
+			return info->bpp;
+	}
+}
+
+static size_t local_row_bytes(yabmp_uint32 width, unsigned int bpp)
+{
+	size_t l_row_bytes = width;
+	l_row_bytes = ((l_row_bytes * (size_t)bpp) + 7U) & ~(size_t)7U;
+	l_row_bytes /= 8U;
+	return l_row_bytes;
+}
+
+/* bpp of rows returned by yabmp_read_row */
+static unsigned int local_transformed_bpp(const yabmp* reader, const yabmp_info* info)
+{
+	if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
+		unsigned int c = 3U;
+		if (((reader->info2.flags  >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) || (reader->transforms & YABMP_TRANSFORM_FILL_ALPHA)) {
+			c++;
+		}
+		return reader->info2.expanded_bps * c;
+	}
+	else if (reader->transforms & YABMP_TRANSFORM_GRAYSCALE) {
+		return 8U;
+	}
+	return info->bpp;
+}
+
+/* size of rows returned by yabmp_read_row, rounded up to the alignment set by yabmp_set_row_alignment */
+static size_t local_transformed_row_bytes(const yabmp* reader, yabmp_uint32 width, unsigned int bpp)
+{
+	size_t l_row_bytes = local_row_bytes(width, bpp);
+	
+	if (reader->row_alignment > 1U) {
+		l_row_bytes = (l_row_bytes + reader->row_alignment - 1U) & ~(size_t)(reader->row_alignment - 1U);
+	}
+	return l_row_bytes;
+}
+
 YABMP_API(yabmp_status, yabmp_create_info, (yabmp* instance, yabmp_info ** info))
 {
 	YABMP_CHECK_INSTANCE(instance);
@@ -100,23 +157,7 @@ YABMP_API(yabmp_status, yabmp_get_bit_depth, (const yabmp* instance, const yabmp
 		return YABMP_ERR_INVALID_ARGS;
 	}
 	
-	/* For now modify this here... */
-	switch ((info->flags>> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK) {
-		case YABMP_COLOR_TYPE_BGR:
-			*bit_depth = info->bpp / 3U;
-			break;
-		case YABMP_COLOR_TYPE_BGR_ALPHA:
-			*bit_depth = info->bpp / 4U;
-			break;
-		case YABMP_COLOR_TYPE_GRAY:
-		case YABMP_COLOR_TYPE_PALETTE:
-		case YABMP_COLOR_TYPE_GRAY_PALETTE:
-		case YABMP_COLOR_TYPE_BITFIELDS:
-		case YABMP_COLOR_TYPE_BITFIELDS_ALPHA:
-		default:
-			*bit_depth = info->bpp;
-			break;
-	}
+	*bit_depth = local_bit_depth(info);
 	return YABMP_OK;
 }
 
@@ -313,6 +354,93 @@ YABMP_API(yabmp_status, yabmp_get_rowbytes, (const yabmp* instance, const yabmp_
 	*row_bytes = info->rowbytes;
 	return YABMP_OK;
 }
+
+YABMP_API(yabmp_status, yabmp_get_header_desc, (const yabmp* reader, const yabmp_info* info, yabmp_header_desc* desc))
+{
+	yabmp_header_desc l_desc;
+	size_t       l_size;
+	unsigned int l_color_type;
+	yabmp_uint32 l_width;
+	
+	YABMP_CHECK_READER(reader);
+	
+	if ((info == NULL) || (desc == NULL)) {
+		yabmp_send_error(reader, "NULL info or NULL desc.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	if (desc->struct_size < YABMP_HEADER_DESC_V1_SIZE) {
+		yabmp_send_error(reader, "Invalid desc->struct_size %zu, expected at least %zu.", desc->struct_size, (size_t)YABMP_HEADER_DESC_V1_SIZE);
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	memset(&l_desc, 0, sizeof(yabmp_header_desc));
+	
+	l_color_type = (info->flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK;
+	
+	l_desc.width          = info->width;
+	l_desc.height         = info->height;
+	l_desc.res_ppm_x      = info->res_ppm_x;
+	l_desc.res_ppm_y      = info->res_ppm_y;
+	l_desc.bit_depth      = local_bit_depth(info);
+	l_desc.color_type     = l_color_type;
+	l_desc.compression    = info->compression;
+	l_desc.scan_direction = (info->flags >> YABMP_SCAN_SHIFT) & YABMP_SCAN_MASK;
+	
+	if ((l_color_type & YABMP_COLOR_MASK_BITFIELDS) != 0U) {
+		l_desc.blue_mask  = info->mask_blue;
+		l_desc.green_mask = info->mask_green;
+		l_desc.red_mask   = info->mask_red;
+		l_desc.alpha_mask = info->mask_alpha;
+	}
+	l_desc.blue_bits  = info->bpc_blue;
+	l_desc.green_bits = info->bpc_green;
+	l_desc.red_bits   = info->bpc_red;
+	l_desc.alpha_bits = info->bpc_alpha;
+	
+	if ((l_color_type & YABMP_COLOR_MASK_PALETTE) != 0U) {
+		l_desc.palette_count = info->num_palette;
+		l_desc.palette       = info->palette;
+	}
+	
+	l_desc.color_profile_type   = info->cp_type;
+	l_desc.color_profile_intent = info->cp_intent;
+	switch (info->cp_type)
+	{
+		case YABMP_COLOR_PROFILE_ICC_EMBEDDED:
+		case YABMP_COLOR_PROFILE_ICC_LINKED:
+			l_desc.icc_profile     = info->icc_profile;
+			l_desc.icc_profile_len = info->icc_profile_size;
+			break;
+		case YABMP_COLOR_PROFILE_CALIBRATED_RGB:
+			l_desc.cie_r   = info->cie_r;
+			l_desc.cie_g   = info->cie_g;
+			l_desc.cie_b   = info->cie_b;
+			l_desc.gamma_r = info->gamma_r;
+			l_desc.gamma_g = info->gamma_g;
+			l_desc.gamma_b = info->gamma_b;
+			break;
+		default:
+			break;
+	}
+	
+	l_desc.row_bytes = info->rowbytes;
+	
+	l_width = info->width;
+	if (reader->status & YABMP_STATUS_HAS_INFO) {
+		l_width = reader->region_width;
+	}
+	l_desc.transformed_row_bytes = local_transformed_row_bytes(reader, l_width, local_transformed_bpp(reader, info));
+	
+	/* only the fields known to the caller are written, struct_size is left as is */
+	l_size = desc->struct_size;
+	if (l_size > sizeof(yabmp_header_desc)) {
+		l_size = sizeof(yabmp_header_desc);
+	}
+	l_desc.struct_size = desc->struct_size;
+	memcpy(desc, &l_desc, l_size);
+	
+	return YABMP_OK;
+}
 YABMP_API(yabmp_status, yabmp_read_update_info, (const yabmp* reader, yabmp_info* info))
 {
 	YABMP_CHECK_READER(reader);
@@ -322,15 +450,18 @@ YABMP_API(yabmp_status, yabmp_read_update_info, (const yabmp* reader, yabmp_info
 		return YABMP_ERR_INVALID_ARGS;
 	}
 	if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
-		unsigned int c = 3U;
 		yabmp_uint8 l_color_type = YABMP_COLOR_TYPE_BGR;
 		info->flags &= ~(YABMP_COLOR_MASK << YABMP_COLOR_SHIFT);
 		if ((reader->info2.flags  >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) {
 			l_color_type |= YABMP_COLOR_MASK_ALPHA;
-			c++;
+		}
+		else if (reader->transforms & YABMP_TRANSFORM_FILL_ALPHA) {
+			/* opaque alpha uses all sample bits */
+			l_color_type |= YABMP_COLOR_MASK_ALPHA;
+			info->bpc_alpha = reader->info2.expanded_bps;
 		}
 		info->flags |= l_color_type << YABMP_COLOR_SHIFT;
-		info->bpp = (yabmp_uint8)(reader->info2.expanded_bps * c);
+		info->bpp = (yabmp_uint8)local_transformed_bpp(reader, info);
 		info->mask_alpha  = 0U;
 		info->mask_blue   = 0U;
 		info->mask_green  = 0U;
@@ -340,7 +471,12 @@ YABMP_API(yabmp_status, yabmp_read_update_info, (const yabmp* reader, yabmp_info
 	else if (reader->transforms & YABMP_TRANSFORM_GRAYSCALE) {
 		info->flags &= ~(YABMP_COLOR_MASK << YABMP_COLOR_SHIFT);
 		info->flags |= YABMP_COLOR_TYPE_GRAY << YABMP_COLOR_SHIFT;
-		info->bpp = 8U;
+		info->bpp = (yabmp_uint8)local_transformed_bpp(reader, info);
+		/* gray levels are computed on full range samples */
+		info->bpc_blue    = 8U;
+		info->bpc_green   = 8U;
+		info->bpc_red     = 8U;
+		info->bpc_alpha   = 0U;
 		info->mask_alpha  = 0U;
 		info->mask_blue   = 0U;
 		info->mask_green  = 0U;
@@ -354,13 +490,14 @@ YABMP_API(yabmp_status, yabmp_read_update_info, (const yabmp* reader, yabmp_info
 	}
 	
 	
-	/* Update row bytes */
-	{
-		size_t l_row_bytes = reader->info2.width;
-		l_row_bytes = ((l_row_bytes * (size_t)info->bpp) + 7U) & ~(size_t)7U;
-		l_row_bytes /= 8U;
-		info->rowbytes = l_row_bytes;
+	if (reader->status & YABMP_STATUS_HAS_INFO) {
+		/* region of interest */
+		info->width  = reader->region_width;
+		info->height = reader->region_height;
 	}
 	
+	/* Update row bytes */
+	info->rowbytes = local_transformed_row_bytes(reader, info->width, info->bpp);
+	
 	return YABMP_OK;
 }
@@ -27,8 +27,164 @@
 #define YABMP_MALLOC_NO_POISON
 #include "../inc/private/yabmp_malloc.h"
 #include "../inc/private/yabmp_message.h"
+#include "../inc/private/yabmp_stream.h"
 #include "../inc/private/yabmp_struct.h"
 
+/* every arena allocation is aligned for any type */
+typedef union yabmp_arena_align_union
+{
+	void*  p;
+	void   (*f)(void);
+	long   l;
+	double d;
+	size_t s;
+} yabmp_arena_align;
+
+#define YABMP_ARENA_ALIGN sizeof(yabmp_arena_align)
+#define YABMP_ARENA_NONE  ((size_t)-1)
+
+YABMP_IAPI(size_t, yabmp_arena_block_size, (size_t size))
+{
+	/* header holding the previous allocation offset, then data */
+	if (size > (((size_t)-1) - 2U * YABMP_ARENA_ALIGN)) {
+		return 0U;
+	}
+	return YABMP_ARENA_ALIGN + ((size + YABMP_ARENA_ALIGN - 1U) / YABMP_ARENA_ALIGN) * YABMP_ARENA_ALIGN;
+}
+
+YABMP_IAPI(void, yabmp_arena_init, (yabmp_arena** arena, void* buffer, size_t buffer_size))
+{
+	yabmp_uint8* l_buffer = (yabmp_uint8*)buffer;
+	size_t l_misalign;
+	size_t l_header_size = yabmp_arena_block_size(sizeof(yabmp_arena)) - YABMP_ARENA_ALIGN;
+	
+	assert(arena != NULL);
+	
+	*arena = NULL;
+	if (buffer == NULL) {
+		return;
+	}
+	l_misalign = (size_t)l_buffer % YABMP_ARENA_ALIGN;
+	if (l_misalign != 0U) {
+		l_misalign = YABMP_ARENA_ALIGN - l_misalign;
+	}
+	if ((buffer_size < l_misalign) || ((buffer_size - l_misalign) < l_header_size)) {
+		return;
+	}
+	l_buffer += l_misalign;
+	
+	/* arena state is stored at the beginning of the buffer */
+	*arena = (yabmp_arena*)l_buffer;
+	(*arena)->base = l_buffer + l_header_size;
+	(*arena)->size = buffer_size - l_misalign - l_header_size;
+	(*arena)->used = 0U;
+	(*arena)->last = YABMP_ARENA_NONE;
+}
+
+YABMP_IAPI(int, yabmp_arena_fits, (const yabmp* instance, size_t size, unsigned int count))
+{
+	size_t l_block_size;
+	
+	assert(instance != NULL);
+	
+	if (instance->arena == NULL) {
+		return 1;
+	}
+	l_block_size = yabmp_arena_block_size(size);
+	if ((l_block_size == 0U) || ((count > 0U) && (l_block_size > (((size_t)-1) / count)))) {
+		return 0;
+	}
+	return (l_block_size * count) <= (instance->arena->size - instance->arena->used);
+}
+
+static void* yabmp_arena_malloc(yabmp_arena* arena, size_t size)
+{
+	size_t l_block_size = yabmp_arena_block_size(size);
+	yabmp_uint8* l_header;
+	
+	if ((l_block_size == 0U) || (l_block_size > (arena->size - arena->used))) {
+		return NULL;
+	}
+	l_header = arena->base + arena->used;
+	((yabmp_arena_align*)l_header)->s = arena->last;
+	arena->last = arena->used;
+	arena->used += l_block_size;
+	return l_header + YABMP_ARENA_ALIGN;
+}
+
+static void yabmp_arena_free(yabmp_arena* arena, void* ptr)
+{
+	/* only the last allocation can be reclaimed, others are reclaimed along with the arena */
+	if ((arena->last != YABMP_ARENA_NONE) && ((yabmp_uint8*)ptr == (arena->base + arena->last + YABMP_ARENA_ALIGN))) {
+		arena->used = arena->last;
+		arena->last = ((const yabmp_arena_align*)(arena->base + arena->last))->s;
+	}
+}
+
+/* adds value to total, returns non zero on overflow */
+static int yabmp_add_size(size_t* total, size_t value)
+{
+	if ((value == 0U) || (value > (((size_t)-1) - *total))) {
+		return 1;
+	}
+	*total += value;
+	return 0;
+}
+
+YABMP_API(yabmp_status, yabmp_query_memory_requirements, (const yabmp_probe_result* probe, unsigned int flags, size_t* size))
+{
+	size_t l_size;
+	size_t l_step_bytes;
+	int l_overflow = 0;
+	
+	if ((probe == NULL) || (size == NULL) || (probe->missing_bytes != 0U) || (probe->bpp == 0U) || (probe->bpp > 32U)) {
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	*size = 0U;
+	
+	/* one step is enough for any intermediate row (see local_setup_read) */
+	if ((size_t)probe->width > ((((size_t)-1) - 7U) / 2U / probe->bpp)) {
+		return YABMP_ERR_UNKNOW;
+	}
+	l_step_bytes = ((size_t)probe->width * probe->bpp + 7U) / 8U;
+	if (probe->compression == YABMP_COMPRESSION_RLE4) {
+		l_step_bytes *= 2U;
+	}
+	l_step_bytes = (l_step_bytes + 3U) & ~(size_t)3U;
+	
+	/* alignment of the caller buffer & arena state */
+	l_size = YABMP_ARENA_ALIGN - 1U;
+	l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(sizeof(yabmp_arena)) - YABMP_ARENA_ALIGN);
+	l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(sizeof(struct yabmp_struct)));
+	l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(sizeof(struct yabmp_info_struct)));
+	l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(l_step_bytes));
+	if ((probe->compression == YABMP_COMPRESSION_RLE4) || (probe->compression == YABMP_COMPRESSION_RLE8)) {
+		/* RLE run patterns, 16 bytes per run value */
+		l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(256U * 16U));
+		/* read-ahead buffer for plain streams, see local_setup_rle_read_buffer */
+		l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(YABMP_RLE_READ_BUFFER_SIZE));
+	}
+	else if (probe->bpp < 8U) {
+		/* palette expansion table, 4 bytes per expanded pixel at most */
+		l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size(256U * (8U / probe->bpp) * 4U));
+	}
+	if ((flags & YABMP_MEMORY_SCALE) && ((probe->bpp == 16U) || (probe->bpp == 32U))) {
+		/* full range tables, at most one 16 bits channel & 3 empty ones with 16 bits samples */
+		l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size((65536UL + 3UL) * sizeof(yabmp_uint16)));
+	}
+	if (flags & YABMP_MEMORY_ROW_INDEX) {
+		if ((size_t)probe->height > (((size_t)-1) / (YABMP_ROW_INDEX_VALUES_PER_ROW * sizeof(yabmp_uint32)))) {
+			return YABMP_ERR_UNKNOW;
+		}
+		l_overflow |= yabmp_add_size(&l_size, yabmp_arena_block_size((size_t)probe->height * YABMP_ROW_INDEX_VALUES_PER_ROW * sizeof(yabmp_uint32)));
+	}
+	if (l_overflow) {
+		return YABMP_ERR_UNKNOW;
+	}
+	*size = l_size;
+	return YABMP_OK;
+}
+
 YABMP_IAPI(void*, yabmp_malloc, (const yabmp* instance, size_t size))
 {
 	void* l_result = NULL;
@@ -36,7 +192,9 @@ YABMP_IAPI(void*, yabmp_malloc, (const yabmp* instance, size_t size))
 	assert(instance != NULL);
 	
 	if (size != 0U) {
-		if (instance->malloc_fn != NULL) {
+		if (instance->arena != NULL) {
+			l_result = yabmp_arena_malloc(instance->arena, size);
+		} else if (instance->malloc_fn != NULL) {
 			l_result = instance->malloc_fn(instance->alloc_context, size);
 		} else {
 			l_result = malloc(size);
@@ -55,7 +213,9 @@ YABMP_IAPI(void,  yabmp_free,   (const yabmp* instance, void* ptr))
 	
 	if (ptr != NULL)
 	{
-		if (instance->free_fn != NULL) {
+		if (instance->arena != NULL) {
+			yabmp_arena_free(instance->arena, ptr);
+		} else if (instance->free_fn != NULL) {
 			instance->free_fn(instance->alloc_context, ptr);
 		} else {
 			free(ptr);
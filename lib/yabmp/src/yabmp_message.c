@@ -37,7 +37,8 @@ YABMP_IAPI(void, yabmp_send_error,   (const yabmp* instance, const char* format,
 	assert(instance != NULL);
 	assert(format != NULL);
 	
-	if (instance->error_fn != NULL) {
+	/* errors following a push starvation are not reported, decoding will be resumed */
+	if ((instance->error_fn != NULL) && !instance->push_starved) {
 		va_list args;
 		
 		va_start(args, format);
@@ -50,7 +51,7 @@ YABMP_IAPI(void, yabmp_send_warning, (const yabmp* instance, const char* format,
 	assert(instance != NULL);
 	assert(format != NULL);
 	
-	if (instance->warning_fn != NULL) {
+	if ((instance->warning_fn != NULL) && !instance->push_starved) {
 		va_list args;
 		
 		va_start(args, format);
@@ -40,6 +40,8 @@ static yabmp_status local_valid_info(yabmp* reader);
 
 static yabmp_status local_rle4_decode_row(yabmp* reader, yabmp_uint8* row, int repack);
 static yabmp_status local_rle8_decode_row(yabmp* reader, yabmp_uint8* row);
+static yabmp_status local_rle_skip_row(yabmp* reader);
+static yabmp_status local_seek_row(yabmp* reader, yabmp_uint32 row);
 
 YABMP_API(yabmp_status, yabmp_create_reader, (
 	yabmp** reader,
@@ -93,6 +95,51 @@ YABMP_API(yabmp_status, yabmp_create_reader, (
 	return l_status;
 }
 
+YABMP_API(yabmp_status, yabmp_create_reader_in_arena, (
+	yabmp** reader,
+	void* message_context,
+	yabmp_message_cb error_fn,
+	yabmp_message_cb warning_fn,
+	void* buffer,
+	size_t buffer_size))
+{
+	yabmp  l_interimInstance;
+	yabmp* l_reader = NULL;
+	
+	memset(&l_interimInstance, 0, sizeof(l_interimInstance));
+	
+	l_interimInstance.kind = YABMP_KIND_READER;
+	
+	l_interimInstance.message_context = message_context;
+	l_interimInstance.error_fn = error_fn;
+	l_interimInstance.warning_fn = warning_fn;
+	
+	/* check reader valid */
+	if ((reader == NULL) || (*reader != NULL)) {
+		yabmp_send_error(&l_interimInstance, "Invalid arguments for yabmp_create_reader_in_arena. \"reader\" is NULL or its content not NULL.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	if (buffer == NULL) {
+		yabmp_send_error(&l_interimInstance, "Invalid arguments for yabmp_create_reader_in_arena. \"buffer\" is NULL.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	yabmp_arena_init(&(l_interimInstance.arena), buffer, buffer_size);
+	if (l_interimInstance.arena != NULL) {
+		l_reader = yabmp_malloc(&l_interimInstance, sizeof(*l_reader));
+	}
+	if (l_reader == NULL) {
+		yabmp_send_error(&l_interimInstance, "Can't allocate yabmp reader.");
+		return YABMP_ERR_ALLOCATION;
+	}
+	memcpy(l_reader, &l_interimInstance, sizeof(l_interimInstance));
+	
+	yabmp_init_info(&(l_reader->info2));
+	yabmp_init_version(l_reader);
+	*reader = l_reader;
+	return YABMP_OK;
+}
+
 YABMP_API(void, yabmp_destroy_reader, (yabmp** reader, yabmp_info** info))
 {
 	/* simple error checking */
@@ -118,10 +165,17 @@ YABMP_API(void, yabmp_destroy_reader, (yabmp** reader, yabmp_info** info))
 		l_interimInstance.alloc_context = l_reader->alloc_context;
 		l_interimInstance.malloc_fn = l_reader->malloc_fn;
 		l_interimInstance.free_fn = l_reader->free_fn;
+		l_interimInstance.arena = l_reader->arena;
 		
 		/* free content */
+		yabmp_free(l_reader, l_reader->read_buffer);
+		yabmp_free(l_reader, l_reader->push_buffer);
+		yabmp_free(l_reader, l_reader->push_row);
 		yabmp_free(l_reader, l_reader->rle_row);
+		yabmp_free(l_reader, l_reader->row_index);
 		yabmp_free(l_reader, l_reader->input_row);
+		yabmp_free(l_reader, l_reader->expand_lut);
+		yabmp_free(l_reader, l_reader->scale_lut_buffer);
 		yabmp_free(l_reader, l_reader->info2.icc_profile);
 		
 		if (l_reader->close_fn != NULL) {
@@ -135,6 +189,53 @@ YABMP_API(void, yabmp_destroy_reader, (yabmp** reader, yabmp_info** info))
 	}
 }
 
+YABMP_API(yabmp_status, yabmp_reset_reader, (yabmp* reader))
+{
+	yabmp l_kept;
+	
+	YABMP_CHECK_READER(reader);
+	
+	if (reader->close_fn != NULL) {
+		reader->close_fn(reader->stream_context);
+	}
+	yabmp_free(reader, reader->row_index);
+	yabmp_free(reader, reader->info2.icc_profile);
+	
+	/* keep settings & buffers, everything else goes back to its initial state */
+	memcpy(&l_kept, reader, sizeof(l_kept));
+	memset(reader, 0, sizeof(*reader));
+	
+	reader->kind = l_kept.kind;
+	reader->version = l_kept.version;
+	reader->alloc_context = l_kept.alloc_context;
+	reader->malloc_fn = l_kept.malloc_fn;
+	reader->free_fn = l_kept.free_fn;
+	reader->arena = l_kept.arena;
+	reader->message_context = l_kept.message_context;
+	reader->error_fn = l_kept.error_fn;
+	reader->warning_fn = l_kept.warning_fn;
+	reader->read_buffer = l_kept.read_buffer;
+	reader->read_buffer_size = l_kept.read_buffer_size;
+	reader->push_buffer = l_kept.push_buffer;
+	reader->push_buffer_size = l_kept.push_buffer_size;
+	reader->push_row = l_kept.push_row;
+	reader->push_row_size = l_kept.push_row_size;
+	reader->input_row = l_kept.input_row;
+	reader->input_row_size = l_kept.input_row_size;
+	reader->rle_row = l_kept.rle_row;
+	reader->rle_row_size = l_kept.rle_row_size;
+	reader->expand_lut = l_kept.expand_lut;
+	reader->expand_lut_size = l_kept.expand_lut_size;
+	reader->scale_lut_buffer = l_kept.scale_lut_buffer;
+	reader->scale_lut_size = l_kept.scale_lut_size;
+	reader->task_count = l_kept.task_count;
+	reader->parallel_fn = l_kept.parallel_fn;
+	reader->parallel_context = l_kept.parallel_context;
+	
+	yabmp_init_info(&(reader->info2));
+	return YABMP_OK;
+}
+
 YABMP_API(yabmp_status, yabmp_set_input_stream, (
 	yabmp* reader,
 	void* stream_context,
@@ -210,6 +311,14 @@ YABMP_API(yabmp_status, yabmp_read_info, (yabmp* reader, yabmp_info* info))
 		reader->info2.rowbytes = l_row_bytes;
 	}
 	
+	/* Whole image until yabmp_set_read_region is called */
+	reader->region_x = 0U;
+	reader->region_y = 0U;
+	reader->region_width  = reader->info2.width;
+	reader->region_height = reader->info2.height;
+	
+	/* info might be reused */
+	yabmp_free(reader, info->icc_profile);
 	memcpy(info, &(reader->info2), sizeof(struct yabmp_info_struct));
 	/* let's recreate icc profile */
 	info->icc_profile = NULL;
@@ -224,6 +333,133 @@ YABMP_API(yabmp_status, yabmp_read_info, (yabmp* reader, yabmp_info* info))
 	return YABMP_OK;
 }
 
+static yabmp_uint32 local_get_le_32u(const yabmp_uint8* data)
+{
+	return (yabmp_uint32)data[0] | ((yabmp_uint32)data[1] << 8) | ((yabmp_uint32)data[2] << 16) | ((yabmp_uint32)data[3] << 24);
+}
+
+static yabmp_uint16 local_get_le_16u(const yabmp_uint8* data)
+{
+	return (yabmp_uint16)(data[0] | (data[1] << 8));
+}
+
+YABMP_API(yabmp_status, yabmp_probe, (const void* data, size_t data_size, yabmp_probe_result* result))
+{
+	const yabmp_uint8* l_data = (const yabmp_uint8*)data;
+	yabmp_uint32 l_header_size;
+	yabmp_uint32 l_compression = 0U; /* BI_RGB */
+	size_t l_needed = 18U; /* file header & DIB header size */
+	
+	if (((data == NULL) && (data_size > 0U)) || (result == NULL)) {
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	memset(result, 0, sizeof(*result));
+	
+	if ((data_size >= 2U) && (local_get_le_16u(l_data) != YABMP_FILE_TYPE('B', 'M'))) {
+		return YABMP_ERR_UNKNOW;
+	}
+	if (data_size < l_needed) {
+		result->missing_bytes = l_needed - data_size;
+		return YABMP_OK;
+	}
+	
+	l_header_size = local_get_le_32u(l_data + 14U);
+	switch (l_header_size) {
+		case 12U:
+			l_needed += 8U; /* width, height, planes, bpp on 16 bits */
+			break;
+		case 16U:
+		case 20U:
+		case 24U:
+		case 28U:
+		case 32U:
+		case 36U:
+		case 40U:
+		case 42U:
+		case 44U:
+		case 46U:
+		case 48U:
+		case 52U:
+		case 56U:
+		case 60U:
+		case 64U:
+		case 108U:
+		case 124U:
+			l_needed += (l_header_size >= 20U) ? 16U : 12U; /* up to compression */
+			break;
+		default:
+			return YABMP_ERR_UNKNOW;
+	}
+	if (data_size < l_needed) {
+		result->missing_bytes = l_needed - data_size;
+		return YABMP_OK;
+	}
+	
+	if (l_header_size == 12U) {
+		result->width  = local_get_le_16u(l_data + 18U);
+		result->height = local_get_le_16u(l_data + 20U);
+		l_data += 22U;
+	}
+	else {
+		result->width  = local_get_le_32u(l_data + 18U);
+		result->height = local_get_le_32u(l_data + 22U);
+		l_data += 26U;
+		if (result->height & 0x80000000U) { /* height is negative 2's complement */
+			result->height = (result->height ^ 0xFFFFFFFFU) + 1U;
+			result->scan_direction = YABMP_SCAN_TOP_DOWN;
+		}
+	}
+	if (local_get_le_16u(l_data) != 1U) { /* color plane count */
+		return YABMP_ERR_UNKNOW;
+	}
+	result->bpp = local_get_le_16u(l_data + 2U);
+	if (l_header_size >= 20U) {
+		l_compression = local_get_le_32u(l_data + 4U);
+	}
+	
+	/* same rules as yabmp_read_info */
+	switch (result->bpp) {
+		case 1U:
+		case 2U:
+		case 4U:
+		case 8U:
+		case 16U:
+		case 24U:
+		case 32U:
+			break;
+		default:
+			return YABMP_ERR_UNKNOW;
+	}
+	switch (l_compression) {
+		case 0U: /* BI_RGB */
+			result->compression = YABMP_COMPRESSION_NONE;
+			break;
+		case 1U: /* BI_RLE8 */
+			if (result->bpp != 8U) {
+				return YABMP_ERR_UNKNOW;
+			}
+			result->compression = YABMP_COMPRESSION_RLE8;
+			break;
+		case 2U: /* BI_RLE4 */
+			if (result->bpp != 4U) {
+				return YABMP_ERR_UNKNOW;
+			}
+			result->compression = YABMP_COMPRESSION_RLE4;
+			break;
+		case 3U: /* BI_BITFIELDS */
+		case 6U: /* BI_ALPHABITFIELDS */
+			if (((result->bpp != 16U) && (result->bpp != 32U)) || ((l_compression == 6U) && (l_header_size != 40U))) {
+				return YABMP_ERR_UNKNOW;
+			}
+			result->compression = YABMP_COMPRESSION_NONE;
+			break;
+		default:
+			return YABMP_ERR_UNKNOW;
+	}
+	result->data_offset = local_get_le_32u((const yabmp_uint8*)data + 10U);
+	return YABMP_OK;
+}
+
 static yabmp_status local_read_info_no_validation(yabmp* reader)
 {
 	yabmp_status   l_status = YABMP_OK;
@@ -487,8 +723,15 @@ static yabmp_status local_read_info_no_validation(yabmp* reader)
 			switch (reader->info2.cp_type) {
 				case YABMP_COLOR_PROFILE_ICC_EMBEDDED:
 				case YABMP_COLOR_PROFILE_ICC_LINKED:
-					if (reader->seek_fn != NULL) {
-						yabmp_uint32 l_offset = reader->stream_offset;
+					if (reader->seek_fn == NULL) {
+						yabmp_send_warning(reader, "No seek function provided. ICC profile will be ignored.");
+						reader->info2.cp_type = YABMP_COLOR_PROFILE_NONE;
+					}
+					else if (!yabmp_arena_fits(reader, l_data_size, 2U)) { /* reader & info copies */
+						yabmp_send_warning(reader, "Not enough memory left in arena. ICC profile will be ignored.");
+						reader->info2.cp_type = YABMP_COLOR_PROFILE_NONE;
+					}
+					else {
 						reader->info2.icc_profile_size = l_data_size;
 						reader->info2.icc_profile = yabmp_malloc(reader, reader->info2.icc_profile_size);
 						if (reader->info2.icc_profile == NULL) {
@@ -498,13 +741,7 @@ static yabmp_status local_read_info_no_validation(yabmp* reader)
 							yabmp_send_error(reader, "Would overflow.");
 							return YABMP_ERR_UNKNOW;
 						}
-						YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, l_bmpheader_offset + l_data_offset));
-						YABMP_SIMPLE_CHECK(yabmp_stream_read(reader, reader->info2.icc_profile, reader->info2.icc_profile_size));
-						YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, l_offset));
-					}
-					else {
-						yabmp_send_warning(reader, "No seek function provided. ICC profile will be ignored.");
-						reader->info2.cp_type = YABMP_COLOR_PROFILE_NONE;
+						YABMP_SIMPLE_CHECK(yabmp_stream_read_at(reader, l_bmpheader_offset + l_data_offset, reader->info2.icc_profile, reader->info2.icc_profile_size));
 					}
 					break;
 				default:
@@ -767,10 +1004,58 @@ static yabmp_status local_valid_info(yabmp* reader)
 	return YABMP_OK;
 }
 
+/* stream bytes parsed in place by RLE decoders, consumed once the row is done */
+typedef struct local_rle_window_struct
+{
+	const yabmp_uint8* data;      /* bytes at stream position, see yabmp_stream_window */
+	size_t             available; /* number of bytes in data */
+	size_t             pos;       /* bytes parsed but not consumed yet */
+} local_rle_window;
+
+static void local_rle_window_open(yabmp* instance, local_rle_window* window)
+{
+	window->available = yabmp_stream_window(instance, &(window->data));
+	window->pos = 0U;
+}
+
+static void local_rle_window_close(yabmp* instance, local_rle_window* window)
+{
+	yabmp_stream_consume(instance, window->pos);
+	window->available = 0U;
+	window->pos = 0U;
+}
+
+/* reads count bytes from the window, goes through the stream when the window is too short */
+static yabmp_status local_rle_read(yabmp* instance, local_rle_window* window, yabmp_uint8* buffer, size_t count)
+{
+	if (count <= (window->available - window->pos)) {
+		memcpy(buffer, window->data + window->pos, count);
+		window->pos += count;
+		return YABMP_OK;
+	}
+	local_rle_window_close(instance, window);
+	YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, buffer, count));
+	local_rle_window_open(instance, window);
+	return YABMP_OK;
+}
+
+static yabmp_status local_rle_skip(yabmp* instance, local_rle_window* window, yabmp_uint32 count)
+{
+	if ((size_t)count <= (window->available - window->pos)) {
+		window->pos += (size_t)count;
+		return YABMP_OK;
+	}
+	local_rle_window_close(instance, window);
+	YABMP_SIMPLE_CHECK(yabmp_stream_skip(instance, count));
+	local_rle_window_open(instance, window);
+	return YABMP_OK;
+}
+
 static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int repack)
 {
 	yabmp_uint32 l_remaining = instance->info2.width;
 	yabmp_uint8* l_dst = row;
+	local_rle_window l_window;
 	
 	if (repack) {
 		l_dst = instance->rle_row;
@@ -788,11 +1073,12 @@ static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int
 		instance->rle_skip_x = 0U;
 	}
 	
+	local_rle_window_open(instance, &l_window);
 	for (;;) /* process one line at a time */
 	{
 		yabmp_uint8  l_values[2];
 		unsigned int l_len;
-		YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, l_values, sizeof(l_values)));
+		YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_values, sizeof(l_values)));
 		l_len = l_values[0];
 		if (l_len) { /* non escaped Encoded mode */
 			yabmp_uint8  l_index = l_values[1];
@@ -802,6 +1088,11 @@ static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int
 			}
 			l_remaining -= l_len;
 			/* write value */
+			if ((l_index >> 4) == (l_index & 0xFU)) {
+				memset(l_dst, l_index & 0xFU, l_len);
+				l_dst += l_len;
+				l_len = 0U;
+			}
 			while (l_len > 1U) {
 				*l_dst++ = l_index >> 4;
 				*l_dst++ = l_index & 0xFU;
@@ -827,7 +1118,7 @@ static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int
 				yabmp_uint8 l_delta[2];
 				unsigned int l_count;
 				
-				YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, l_delta, sizeof(l_delta)));
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_delta, sizeof(l_delta)));
 				
 				l_count = l_delta[0];
 				if (l_count > l_remaining) {
@@ -837,9 +1128,8 @@ static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int
 				if (l_delta[1] == 0U) {
 					/* only dx */
 					l_remaining -= l_count;
-					while (l_count-- > 0U) {
-						*l_dst++ = 0U;
-					}
+					memset(l_dst, 0, l_count);
+					l_dst += l_count;
 				}
 				else {
 					memset(l_dst, 0, l_remaining);
@@ -857,10 +1147,10 @@ static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int
 					l_abs = (unsigned int)l_remaining;
 				}
 				l_remaining -= l_abs;
-				YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, l_buffer, (l_abs + 1U) / 2U ));
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_buffer, (l_abs + 1U) / 2U ));
 				if (((l_abs + 1U) / 2U) & 1U) { /* skip padding byte */
 					yabmp_uint8 l_padding;
-					YABMP_SIMPLE_CHECK(yabmp_stream_read_8u(instance,  &l_padding));
+					YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, &l_padding, 1U));
 				}
 				
 				for (i = 0U; i < l_abs / 2U; ++i) {
@@ -874,11 +1164,12 @@ static yabmp_status local_rle4_decode_row(yabmp* instance, yabmp_uint8* row, int
 			}
 		}
 	}
+	local_rle_window_close(instance, &l_window);
 REPACK:
 	if (repack) {
 		yabmp_uint32 i;
-		yabmp_uint32 l_len = instance->info2.width;
-		yabmp_uint8* l_src = instance->rle_row;
+		yabmp_uint32 l_len = instance->region_width;
+		yabmp_uint8* l_src = instance->rle_row + instance->region_x;
 		
 		for (i = 0U; i < l_len / 2U; ++i) {
 			row[i] = (l_src[2*i] << 4) | (l_src[2*i+1]);
@@ -893,6 +1184,7 @@ REPACK:
 static yabmp_status local_rle8_decode_row(yabmp* instance, yabmp_uint8* row)
 {
 	yabmp_uint32 l_remaining = instance->info2.width;
+	local_rle_window l_window;
 	
 	if (instance->rle_skip_y > 0) {
 		memset(row, 0, l_remaining);
@@ -907,11 +1199,12 @@ static yabmp_status local_rle8_decode_row(yabmp* instance, yabmp_uint8* row)
 		instance->rle_skip_x = 0U;
 	}
 	
+	local_rle_window_open(instance, &l_window);
 	for (;;) {
 		yabmp_uint8 l_values[2];
 		unsigned int l_len;
 		
-		YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, l_values, sizeof(l_values)));
+		YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_values, sizeof(l_values)));
 		l_len = l_values[0];
 		if (l_len) { /* non escaped Encoded mode */
 			yabmp_uint8  l_index = l_values[1];
@@ -921,9 +1214,8 @@ static yabmp_status local_rle8_decode_row(yabmp* instance, yabmp_uint8* row)
 			}
 			l_remaining -= l_len;
 			/* write value */
-			while (l_len-- > 0U) {
-				*row++ = l_index;
-			}
+			memset(row, l_index, l_len);
+			row += l_len;
 		}
 		else { /* escaped mode */
 			unsigned int l_abs = l_values[1];
@@ -941,7 +1233,7 @@ static yabmp_status local_rle8_decode_row(yabmp* instance, yabmp_uint8* row)
 				yabmp_uint8 l_delta[2];
 				unsigned int l_count;
 				
-				YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, l_delta, sizeof(l_delta)));
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_delta, sizeof(l_delta)));
 				
 				l_count = l_delta[0];
 				if (l_count > l_remaining) {
@@ -951,9 +1243,8 @@ static yabmp_status local_rle8_decode_row(yabmp* instance, yabmp_uint8* row)
 				if (l_delta[1] == 0U) {
 					/* only dx */
 					l_remaining -= l_count;
-					while (l_count-- > 0U) {
-						*row++ = 0U;
-					}
+					memset(row, 0, l_count);
+					row += l_count;
 				}
 				else {
 					memset(row, 0, l_remaining);
@@ -969,148 +1260,800 @@ static yabmp_status local_rle8_decode_row(yabmp* instance, yabmp_uint8* row)
 					l_abs = (unsigned int)l_remaining;
 				}
 				l_remaining -= l_abs;
-				YABMP_SIMPLE_CHECK(yabmp_stream_read(instance, row, l_abs));
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, row, l_abs));
 				row += l_abs;
 				if (l_abs & 1U) { /* skip padding byte */
 					yabmp_uint8 l_padding;
-					YABMP_SIMPLE_CHECK(yabmp_stream_read_8u(instance,  &l_padding));
+					YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, &l_padding, 1U));
 				}
 			}
 		}
 	}
+	local_rle_window_close(instance, &l_window);
 	return YABMP_OK;
 }
 
-static yabmp_status local_setup_read(yabmp* reader)
+/* writes count pixels of an RLE run starting at column x clipped to the region, run value 0 for skipped pixels */
+static void local_rle_expand_run(const yabmp* instance, yabmp_uint8* row, yabmp_uint32 x, yabmp_uint32 count, unsigned int value)
 {
-	yabmp_uint32 l_rle4_factor = 1U;
-	assert(reader != NULL);
+	yabmp_uint32 l_begin = x;
+	yabmp_uint32 l_end = x + count;
+	yabmp_uint32 l_region_end = instance->region_x + instance->region_width;
+	unsigned int l_pixel_bytes = instance->rle_expand_bytes;
+	yabmp_uint32 l_step, l_min;
+	const yabmp_uint8* l_pattern;
+	yabmp_uint8* l_dst;
 	
-	if (reader->rle_row != NULL) {
-		yabmp_free(reader, reader->rle_row);
-		reader->rle_row = NULL;
-	}
-	if (reader->input_row != NULL) {
-		yabmp_free(reader, reader->input_row);
-		reader->input_row = NULL;
+	if (l_begin < instance->region_x) {
+		l_begin = instance->region_x;
 	}
-	
-	if (reader->data_offset < reader->stream_offset) {
-		yabmp_send_error(reader, "Invalid data offset.");
-		return YABMP_ERR_UNKNOW;
+	if (l_end > l_region_end) {
+		l_end = l_region_end;
 	}
-	if (reader->data_offset > reader->stream_offset) {
-		YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, reader->data_offset - reader->stream_offset));
+	if (l_begin >= l_end) {
+		return;
 	}
+	count = l_end - l_begin;
+	l_pattern = instance->expand_lut + 16U * value;
+	l_dst = row + (size_t)(l_begin - instance->region_x) * l_pixel_bytes;
 	
-	switch (reader->info2.compression) {
-		case YABMP_COMPRESSION_RLE4:
-			l_rle4_factor = 2U;
-			break;
-		case YABMP_COMPRESSION_NONE:
-		case YABMP_COMPRESSION_RLE8:
-		default:
-			break;
+	if ((l_begin - x) & 1U) {
+		/* clipped RLE4 run starts on its second index */
+		memcpy(l_dst, l_pattern + l_pixel_bytes, l_pixel_bytes);
+		l_dst += l_pixel_bytes;
+		count--;
 	}
-	
-	if ((sizeof(size_t) > sizeof(yabmp_uint32)) && (reader->info2.rowbytes > 0xFFFFFFFFU)) {
-		yabmp_send_error(reader, "Would overflow.");
-		return YABMP_ERR_UNKNOW;
+	/* an even number of pixels per store keeps RLE4 index pairs in place, 16 bytes stores must not go past the run */
+	l_step = (l_pixel_bytes == 1U) ? 16U : 4U;
+	l_min  = (l_pixel_bytes == 3U) ? 6U : l_step;
+	for (; count >= l_min; count -= l_step) {
+		memcpy(l_dst, l_pattern, 16U);
+		l_dst += l_step * l_pixel_bytes;
 	}
-	reader->input_row_bytes  = (yabmp_uint32)reader->info2.rowbytes;
-	reader->transformed_row_bytes = reader->input_row_bytes; /* no transforms */
+	memcpy(l_dst, l_pattern, count * l_pixel_bytes);
+}
+
+/* writes count absolute mode pixels starting at column x clipped to the region, indices are expand_lut entries */
+static void local_rle_expand_indices(const yabmp* instance, yabmp_uint8* row, yabmp_uint32 x, yabmp_uint32 count, const yabmp_uint8* indices)
+{
+	yabmp_uint32 l_begin = x;
+	yabmp_uint32 l_end = x + count;
+	yabmp_uint32 l_region_end = instance->region_x + instance->region_width;
+	const yabmp_uint8* l_lut = instance->expand_lut;
+	yabmp_uint32 i;
+	yabmp_uint8* l_dst;
 	
-	if (reader->input_row_bytes & ((l_rle4_factor - 1U) << 31U)) { /* l_rle4_factor is 1 or 2 */
-		yabmp_send_error(reader, "Would overflow.");
-		return YABMP_ERR_UNKNOW;
+	if (l_begin < instance->region_x) {
+		l_begin = instance->region_x;
 	}
-	reader->input_step_bytes = reader->input_row_bytes * l_rle4_factor;
-	if (reader->input_step_bytes > (0xFFFFFFFFU - 3U)) {
-		yabmp_send_error(reader, "Would overflow.");
-		return YABMP_ERR_UNKNOW;
+	if (l_end > l_region_end) {
+		l_end = l_region_end;
 	}
-	reader->input_step_bytes = (reader->input_step_bytes + 3U) & ~(yabmp_uint32)3U;
+	if (l_begin >= l_end) {
+		return;
+	}
+	l_dst = row + (size_t)(l_begin - instance->region_x) * instance->rle_expand_bytes;
+	indices += l_begin - x;
+	count = l_end - l_begin;
 	
-	if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
-		YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, reader->input_step_bytes * (yabmp_uint32)(reader->info2.height - 1U)));
+	switch (instance->rle_expand_bytes) {
+		case 1U:
+			for (i = 0U; i < count; ++i) {
+				l_dst[i] = l_lut[16U * indices[i]];
+			}
+			break;
+		case 3U:
+			/* 4 bytes stores, the last byte is rewritten by the next pixel */
+			for (i = 0U; i + 1U < count; ++i) {
+				memcpy(l_dst, l_lut + 16U * indices[i], 4U);
+				l_dst += 3;
+			}
+			memcpy(l_dst, l_lut + 16U * indices[i], 3U);
+			break;
+		default:
+			for (i = 0U; i < count; ++i) {
+				memcpy(l_dst, l_lut + 16U * indices[i], 4U);
+				l_dst += 4;
+			}
+			break;
 	}
+}
+
+/* decodes one RLE4 or RLE8 row straight to palette colors of the region, same stream handling as local_rle8_decode_row */
+static yabmp_status local_rle_expand_row(yabmp* instance, yabmp_uint8* row)
+{
+	yabmp_uint32 l_width = instance->info2.width;
+	yabmp_uint32 l_remaining = l_width;
+	int l_rle4 = instance->info2.compression == YABMP_COMPRESSION_RLE4;
+	local_rle_window l_window;
 	
-	if ((reader->transforms & (YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE)) == (YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE)) {
-		yabmp_send_error(reader, "Can't apply YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE transforms.");
-		return YABMP_ERR_UNKNOW;
+	if (instance->rle_skip_y > 0) {
+		local_rle_expand_run(instance, row, 0U, l_width, 0U);
+		instance->rle_skip_y--;
+		return YABMP_OK;
 	}
 	
-	/* First see if we must clear that (when format is already expanded) */
-	if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
-		if (reader->info2.bpp == 24U) {
-			reader->transforms &= ~YABMP_TRANSFORM_EXPAND;
-		}
+	if (instance->rle_skip_x) {
+		local_rle_expand_run(instance, row, 0U, instance->rle_skip_x, 0U);
+		l_remaining -= instance->rle_skip_x;
+		instance->rle_skip_x = 0U;
 	}
 	
-	/* TODO no LUT for 8bpp ?? */
-	if (reader->transforms & (YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE)) {
-		reader->input_row = yabmp_malloc(reader, reader->input_step_bytes);
-		if (reader->input_row == NULL) {
-			return YABMP_ERR_ALLOCATION;
-		}
+	local_rle_window_open(instance, &l_window);
+	for (;;) {
+		yabmp_uint8 l_values[2];
+		unsigned int l_len;
 		
-		if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
-			/* BGR or BGR(A) */
-			/* TODO 32bpp */
-			yabmp_uint32 l_Bpc = reader->info2.expanded_bps / 8U;
-			if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) {
-				l_Bpc *= 4U;
-			} else {
-				l_Bpc *= 3U;
-			}
-			if (reader->info2.width > (0xFFFFFFFFU / l_Bpc)) {
-				yabmp_send_error(reader, "Would overflow.");
-				return YABMP_ERR_UNKNOW;
+		YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_values, sizeof(l_values)));
+		l_len = l_values[0];
+		if (l_len) { /* non escaped Encoded mode */
+			if (l_len > l_remaining) {
+				/* limit to remaining */
+				l_len = (unsigned int)l_remaining;
 			}
-			reader->transformed_row_bytes = reader->info2.width * l_Bpc;
-		}
-		else if (reader->transforms & YABMP_TRANSFORM_GRAYSCALE) {
-			reader->transformed_row_bytes = reader->info2.width;
-		}
-	}
-	else if (reader->info2.compression == YABMP_COMPRESSION_RLE4) {
-		/* we need an intermediate buffer */
-		/* Overflow check already done for reader->input_step_bytes */
-		reader->rle_row = yabmp_malloc(reader, reader->input_row_bytes * 2U);
-		if (reader->rle_row == NULL) {
-			return YABMP_ERR_ALLOCATION;
-		}
-	}
-	
-	if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
-		if (reader->info2.bpp == 1U) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal1_to_bgr24;
-		}
-		else if (reader->info2.bpp == 2U) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal2_to_bgr24;
-		}
-		else if ((reader->info2.bpp == 4U) && (reader->info2.compression != YABMP_COMPRESSION_RLE4)) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal4_to_bgr24;
-		}
-		else if ((reader->info2.bpp == 8U) || (reader->info2.compression == YABMP_COMPRESSION_RLE4)) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal8_to_bgr24;
+			local_rle_expand_run(instance, row, l_width - l_remaining, l_len, l_values[1]);
+			l_remaining -= l_len;
 		}
-		else if (reader->info2.bpp == 16U) {
-			if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) {
-				if (reader->info2.expanded_bps == 8U) {
-					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgra32;
-				} else {
-					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgra64;
-				}
-			} else {
-				if (reader->info2.expanded_bps == 8U) {
-					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgr24;
-				} else {
-					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgr48;
-				}
-			}
+		else { /* escaped mode */
+			unsigned int l_abs = l_values[1];
+			
+			if (l_abs == 0U) { /* end of line */
+				local_rle_expand_run(instance, row, l_width - l_remaining, l_remaining, 0U);
+				break;
+			}
+			else if (l_abs == 1U) { /* end of bitmap */
+				local_rle_expand_run(instance, row, l_width - l_remaining, l_remaining, 0U);
+				instance->rle_skip_y = UINT_MAX;
+				break;
+			}
+			else if (l_abs == 2U) { /* delta dx,dy */
+				yabmp_uint8 l_delta[2];
+				unsigned int l_count;
+				
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_delta, sizeof(l_delta)));
+				
+				l_count = l_delta[0];
+				if (l_count > l_remaining) {
+					/* limit to remaining */
+					l_count = (unsigned int)l_remaining;
+				}
+				if (l_delta[1] == 0U) {
+					/* only dx */
+					local_rle_expand_run(instance, row, l_width - l_remaining, l_count, 0U);
+					l_remaining -= l_count;
+				}
+				else {
+					local_rle_expand_run(instance, row, l_width - l_remaining, l_remaining, 0U);
+					instance->rle_skip_x = (l_width - l_remaining) + l_count;
+					instance->rle_skip_y = l_delta[1] - 1U;
+					break;
+				}
+			}
+			else /* absolute mode */
+			{
+				yabmp_uint8  l_indices[256];
+				unsigned int l_bytes;
+				
+				if (l_abs > l_remaining) {
+					/* limit to remaining */
+					l_abs = (unsigned int)l_remaining;
+				}
+				l_bytes = l_rle4 ? ((l_abs + 1U) / 2U) : l_abs;
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_indices, l_bytes));
+				if (l_bytes & 1U) { /* skip padding byte */
+					yabmp_uint8 l_padding;
+					YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, &l_padding, 1U));
+				}
+				if (l_rle4) {
+					/* unpack backward in place to single index runs entries */
+					unsigned int i = l_abs;
+					
+					while (i-- > 0U) {
+						l_indices[i] = (yabmp_uint8)(((i & 1U) ? (l_indices[i / 2U] & 0xFU) : (l_indices[i / 2U] >> 4)) * 0x11U);
+					}
+				}
+				local_rle_expand_indices(instance, row, l_width - l_remaining, l_abs, l_indices);
+				l_remaining -= l_abs;
+			}
+		}
+	}
+	local_rle_window_close(instance, &l_window);
+	return YABMP_OK;
+}
+
+/* goes through one RLE4 or RLE8 row without writing pixels */
+static yabmp_status local_rle_skip_row(yabmp* instance)
+{
+	yabmp_uint32 l_remaining = instance->info2.width;
+	local_rle_window l_window;
+	
+	if (instance->rle_skip_y > 0) {
+		instance->rle_skip_y--;
+		return YABMP_OK;
+	}
+	
+	if (instance->rle_skip_x) {
+		l_remaining -= instance->rle_skip_x;
+		instance->rle_skip_x = 0U;
+	}
+	
+	local_rle_window_open(instance, &l_window);
+	for (;;) {
+		yabmp_uint8 l_values[2];
+		unsigned int l_len;
+		
+		YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_values, sizeof(l_values)));
+		l_len = l_values[0];
+		if (l_len) { /* non escaped Encoded mode */
+			if (l_len > l_remaining) {
+				/* limit to remaining */
+				l_len = (unsigned int)l_remaining;
+			}
+			l_remaining -= l_len;
+		}
+		else { /* escaped mode */
+			unsigned int l_abs = l_values[1];
+			
+			if (l_abs == 0U) { /* end of line */
+				break;
+			}
+			else if (l_abs == 1U) { /* end of bitmap */
+				instance->rle_skip_y = UINT_MAX;
+				break;
+			}
+			else if (l_abs == 2U) { /* delta dx,dy */
+				yabmp_uint8 l_delta[2];
+				unsigned int l_count;
+				
+				YABMP_SIMPLE_CHECK(local_rle_read(instance, &l_window, l_delta, sizeof(l_delta)));
+				
+				l_count = l_delta[0];
+				if (l_count > l_remaining) {
+					/* limit to remaining */
+					l_count = (unsigned int)l_remaining;
+				}
+				if (l_delta[1] == 0U) {
+					/* only dx */
+					l_remaining -= l_count;
+				}
+				else {
+					instance->rle_skip_x = (instance->info2.width - l_remaining) + l_count;
+					instance->rle_skip_y = l_delta[1] - 1U;
+					break;
+				}
+			}
+			else /* absolute mode, same stream consumption as decoders */
+			{
+				if (l_abs > l_remaining) {
+					/* limit to remaining */
+					l_abs = (unsigned int)l_remaining;
+				}
+				l_remaining -= l_abs;
+				if (instance->info2.compression == YABMP_COMPRESSION_RLE4) {
+					l_abs = (l_abs + 1U) / 2U;
+				}
+				/* skip padding byte as well */
+				YABMP_SIMPLE_CHECK(local_rle_skip(instance, &l_window, (yabmp_uint32)(l_abs + (l_abs & 1U))));
+			}
+		}
+	}
+	local_rle_window_close(instance, &l_window);
+	return YABMP_OK;
+}
+
+/* returns non zero when only some columns are read */
+static int local_has_column_region(const yabmp* reader)
+{
+	return (reader->region_x != 0U) || (reader->region_width != reader->info2.width);
+}
+
+/* realigns packed pixels on the first bit of dst, src and dst can be the same buffer */
+static void local_shift_row(const yabmp_uint8* src, yabmp_uint8* dst, yabmp_uint32 src_bytes, yabmp_uint32 dst_bytes, unsigned int shift)
+{
+	yabmp_uint32 i;
+	
+	assert((shift > 0U) && (shift < 8U));
+	
+	for (i = 0U; i < dst_bytes; ++i) {
+		unsigned int l_value = (unsigned int)src[i] << shift;
+		if ((i + 1U) < src_bytes) {
+			l_value |= (unsigned int)src[i + 1U] >> (8U - shift);
+		}
+		dst[i] = (yabmp_uint8)l_value;
+	}
+}
+
+/* grows buffer to at least size bytes, content is not kept, buffer is freed on failure */
+static void* local_reserve(yabmp* reader, void* buffer, size_t* buffer_size, size_t size)
+{
+	assert(reader != NULL);
+	assert(buffer_size != NULL);
+	
+	if ((buffer != NULL) && (*buffer_size >= size)) {
+		return buffer;
+	}
+	yabmp_free(reader, buffer);
+	buffer = yabmp_malloc(reader, size);
+	*buffer_size = (buffer != NULL) ? size : 0U;
+	return buffer;
+}
+
+/* bytes_per_pixel is 4 for BGRA32, 3 for BGR24 or 1 for Y8 */
+static yabmp_status local_setup_expand_lut(yabmp* reader, unsigned int bytes_per_pixel)
+{
+	unsigned int l_bpp = reader->info2.bpp;
+	
+	reader->expand_lut = (yabmp_uint8*)local_reserve(reader, reader->expand_lut, &reader->expand_lut_size, 256U * (8U / l_bpp) * bytes_per_pixel);
+	if (reader->expand_lut == NULL) {
+		return YABMP_ERR_ALLOCATION;
+	}
+	yabmp_prepare_expand_lut(reader, l_bpp, bytes_per_pixel);
+	return YABMP_OK;
+}
+
+static int local_has_masks(const yabmp_info* info, yabmp_uint32 blue, yabmp_uint32 green, yabmp_uint32 red)
+{
+	return (info->mask_blue == blue) && (info->mask_green == green) && (info->mask_red == red);
+}
+
+/* builds full range tables & replaces the generic kernel with its scaled version */
+static yabmp_status local_setup_scale(yabmp* reader)
+{
+	static const struct {
+		yabmp_transform_fn generic_fn;
+		yabmp_transform_fn scaled_fn;
+	} l_kernels[] = {
+		{ (yabmp_transform_fn)yabmp_bf16u_to_bgr24,  (yabmp_transform_fn)yabmp_bf16u_to_bgr24_scaled },
+		{ (yabmp_transform_fn)yabmp_bf16u_to_bgr48,  (yabmp_transform_fn)yabmp_bf16u_to_bgr48_scaled },
+		{ (yabmp_transform_fn)yabmp_bf16u_to_bgra32, (yabmp_transform_fn)yabmp_bf16u_to_bgra32_scaled },
+		{ (yabmp_transform_fn)yabmp_bf16u_to_bgra64, (yabmp_transform_fn)yabmp_bf16u_to_bgra64_scaled },
+		{ (yabmp_transform_fn)yabmp_bf32u_to_bgr24,  (yabmp_transform_fn)yabmp_bf32u_to_bgr24_scaled },
+		{ (yabmp_transform_fn)yabmp_bf32u_to_bgr48,  (yabmp_transform_fn)yabmp_bf32u_to_bgr48_scaled },
+		{ (yabmp_transform_fn)yabmp_bf32u_to_bgra32, (yabmp_transform_fn)yabmp_bf32u_to_bgra32_scaled },
+		{ (yabmp_transform_fn)yabmp_bf32u_to_bgra64, (yabmp_transform_fn)yabmp_bf32u_to_bgra64_scaled }
+	};
+	unsigned int l_bits[4];
+	unsigned int l_dummy_shift;
+	unsigned int l_target_bits = reader->info2.expanded_bps;
+	size_t l_sample_bytes = l_target_bits / 8U;
+	size_t l_size = 0U;
+	yabmp_uint8* l_lut;
+	unsigned int c, i;
+	
+	for (i = 0U; i < sizeof(l_kernels) / sizeof(l_kernels[0]); ++i) {
+		if (reader->transform_fn == l_kernels[i].generic_fn) {
+			reader->transform_fn = l_kernels[i].scaled_fn;
+			break;
+		}
+	}
+	
+	for (c = 0U; c < 4U; ++c) {
+		yabmp_bitfield_get_shift_and_bits(reader->out_mask[c], &l_dummy_shift, &l_bits[c]);
+		l_size += ((size_t)1U << l_bits[c]) * l_sample_bytes;
+	}
+	
+	reader->scale_lut_buffer = local_reserve(reader, reader->scale_lut_buffer, &reader->scale_lut_size, l_size);
+	if (reader->scale_lut_buffer == NULL) {
+		return YABMP_ERR_ALLOCATION;
+	}
+	l_lut = (yabmp_uint8*)reader->scale_lut_buffer;
+	for (c = 0U; c < 4U; ++c) {
+		yabmp_uint32 l_value, l_count = (yabmp_uint32)1U << l_bits[c];
+		
+		reader->scale_lut[c] = l_lut;
+		for (l_value = 0U; l_value < l_count; ++l_value) {
+			yabmp_uint32 l_scaled = yabmp_bitfield_replicate(l_value, l_bits[c], l_target_bits) | reader->out_fill[c];
+			
+			if (l_sample_bytes == 1U) {
+				l_lut[l_value] = (yabmp_uint8)l_scaled;
+			} else if (reader->out_swap16) {
+				((yabmp_uint16*)l_lut)[l_value] = (yabmp_uint16)(((l_scaled >> 8) & 0xFFU) | ((l_scaled & 0xFFU) << 8));
+			} else {
+				((yabmp_uint16*)l_lut)[l_value] = (yabmp_uint16)l_scaled;
+			}
+		}
+		l_lut += (size_t)l_count * l_sample_bytes;
+	}
+	return YABMP_OK;
+}
+
+/* computes bitfield masks & shifts in output order once & replaces the generic kernel for common masks */
+static yabmp_status local_setup_bitfields(yabmp* reader)
+{
+	/* 5 bits blue & red kernels, [555 or 565][plain or scaled][3 or 4 channels] */
+	static const yabmp_transform_fn l_bf16u_kernels[2][2][2] = {
+		{
+			{ (yabmp_transform_fn)yabmp_bf16u_555_to_bgr24,        (yabmp_transform_fn)yabmp_bf16u_555_to_bgra32 },
+			{ (yabmp_transform_fn)yabmp_bf16u_555_to_bgr24_scaled, (yabmp_transform_fn)yabmp_bf16u_555_to_bgra32_scaled }
+		},
+		{
+			{ (yabmp_transform_fn)yabmp_bf16u_565_to_bgr24,        (yabmp_transform_fn)yabmp_bf16u_565_to_bgra32 },
+			{ (yabmp_transform_fn)yabmp_bf16u_565_to_bgr24_scaled, (yabmp_transform_fn)yabmp_bf16u_565_to_bgra32_scaled }
+		}
+	};
+#if defined(YABMP_HAVE_X86_SIMD)
+	static const yabmp_transform_fn l_bf16u_kernels_sse41[2][2][2] = {
+		{
+			{ (yabmp_transform_fn)yabmp_bf16u_555_to_bgr24_sse41,        (yabmp_transform_fn)yabmp_bf16u_555_to_bgra32_sse41 },
+			{ (yabmp_transform_fn)yabmp_bf16u_555_to_bgr24_scaled_sse41, (yabmp_transform_fn)yabmp_bf16u_555_to_bgra32_scaled_sse41 }
+		},
+		{
+			{ (yabmp_transform_fn)yabmp_bf16u_565_to_bgr24_sse41,        (yabmp_transform_fn)yabmp_bf16u_565_to_bgra32_sse41 },
+			{ (yabmp_transform_fn)yabmp_bf16u_565_to_bgr24_scaled_sse41, (yabmp_transform_fn)yabmp_bf16u_565_to_bgra32_scaled_sse41 }
+		}
+	};
+	int l_sse41 = (yabmp_get_cpu_features() & YABMP_CPU_SSE41) != 0U;
+#endif
+	unsigned int l_dummy_bits;
+	unsigned int c;
+	int l_default_layout, l_fill_alpha, l_scale;
+	const yabmp_info* l_info = &(reader->info2);
+	
+	l_fill_alpha = (((l_info->flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) == 0U) && ((reader->transforms & YABMP_TRANSFORM_FILL_ALPHA) != 0U);
+	
+	reader->out_mask[0] = l_info->mask_blue;
+	reader->out_mask[1] = l_info->mask_green;
+	reader->out_mask[2] = l_info->mask_red;
+	reader->out_mask[3] = l_info->mask_alpha;
+	if (reader->output_format & YABMP_OUTPUT_RGB) {
+		reader->out_mask[0] = l_info->mask_red;
+		reader->out_mask[2] = l_info->mask_blue;
+	}
+	if ((reader->output_format & YABMP_OUTPUT_ALPHA_FIRST) && (((l_info->flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) || l_fill_alpha)) {
+		yabmp_uint32 l_alpha = reader->out_mask[3];
+		
+		reader->out_mask[3] = reader->out_mask[2];
+		reader->out_mask[2] = reader->out_mask[1];
+		reader->out_mask[1] = reader->out_mask[0];
+		reader->out_mask[0] = l_alpha;
+	}
+	for (c = 0U; c < 4U; ++c) {
+		yabmp_bitfield_get_shift_and_bits(reader->out_mask[c], &reader->out_shift[c], &l_dummy_bits);
+		reader->out_fill[c] = 0U;
+	}
+	if (l_fill_alpha) {
+		/* alpha slot has no mask, all sample bits are set */
+		reader->out_fill[(reader->output_format & YABMP_OUTPUT_ALPHA_FIRST) ? 0U : 3U] = ((yabmp_uint32)1U << l_info->expanded_bps) - 1U;
+	}
+#if !defined(YABMP_BIG_ENDIAN)
+	reader->out_swap16 = (reader->output_format & YABMP_OUTPUT_BIG_ENDIAN) && (l_info->expanded_bps == 16U);
+#endif
+	/* kernels with fixed channel positions, others read out_shift */
+	l_default_layout = ((reader->output_format & (YABMP_OUTPUT_RGB | YABMP_OUTPUT_ALPHA_FIRST)) == 0U) && !reader->out_swap16;
+	
+	/* nothing to scale when all channels are already full range, fast paths below still apply */
+	l_scale = (reader->transforms & YABMP_TRANSFORM_SCALE) && (
+		(l_info->bpc_blue != l_info->expanded_bps) ||
+		(l_info->bpc_green != l_info->expanded_bps) ||
+		(l_info->bpc_red != l_info->expanded_bps) ||
+		((l_info->mask_alpha != 0U) && (l_info->bpc_alpha != l_info->expanded_bps)));
+	
+	/* green stays in the middle, filled alpha must come last */
+	if ((reader->transform_fn == (yabmp_transform_fn)yabmp_bf16u_to_bgr24) ||
+		((reader->transform_fn == (yabmp_transform_fn)yabmp_bf16u_to_bgra32) && l_fill_alpha && ((reader->output_format & YABMP_OUTPUT_ALPHA_FIRST) == 0U))) {
+		int l_565 = local_has_masks(l_info, 0x001FU, 0x07E0U, 0xF800U);
+		int l_bgra = reader->transform_fn == (yabmp_transform_fn)yabmp_bf16u_to_bgra32;
+		
+		if (l_565 || local_has_masks(l_info, 0x001FU, 0x03E0U, 0x7C00U)) {
+			reader->transform_fn = l_bf16u_kernels[l_565][l_scale][l_bgra];
+#if defined(YABMP_HAVE_X86_SIMD)
+			if (l_sse41) {
+				reader->transform_fn = l_bf16u_kernels_sse41[l_565][l_scale][l_bgra];
+			}
+#endif
+			return YABMP_OK;
+		}
+	}
+	
+	if (l_scale) {
+		if (l_default_layout && (reader->transform_fn == (yabmp_transform_fn)yabmp_bf32u_to_bgra64)) {
+			if (local_has_masks(l_info, 0x000003FFU, 0x000FFC00U, 0x3FF00000U) && (l_info->mask_alpha == 0xC0000000U)) {
+				reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_a2r10g10b10_to_bgra64_scaled;
+				return YABMP_OK;
+			}
+		}
+		return local_setup_scale(reader);
+	}
+	
+	if (reader->transform_fn == (yabmp_transform_fn)yabmp_bf32u_to_bgr24) {
+		if (local_has_masks(l_info, 0x000000FFU, 0x0000FF00U, 0x00FF0000U)) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_x8r8g8b8_to_bgr24;
+#if defined(YABMP_HAVE_X86_SIMD)
+			if (l_sse41) {
+				reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_x8r8g8b8_to_bgr24_sse41;
+			}
+#endif
+		}
+	}
+	else if (reader->transform_fn == (yabmp_transform_fn)yabmp_bf32u_to_bgra32) {
+		if (local_has_masks(l_info, 0x000000FFU, 0x0000FF00U, 0x00FF0000U) && ((l_info->mask_alpha == 0xFF000000U) || l_fill_alpha)) {
+			if (l_default_layout) {
+				if (l_fill_alpha) {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_x8r8g8b8_to_bgra32;
+				} else {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_a8r8g8b8_to_bgra32;
+				}
+			}
+#if defined(YABMP_HAVE_X86_SIMD)
+			/* a8r8g8b8 is a plain copy in the default layout */
+			if (l_sse41 && (!l_default_layout || l_fill_alpha)) {
+				reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_8888_swizzle_sse41;
+			}
+#endif
+		}
+	}
+	else if (l_default_layout && (reader->transform_fn == (yabmp_transform_fn)yabmp_bf32u_to_bgra64)) {
+		if (local_has_masks(l_info, 0x000003FFU, 0x000FFC00U, 0x3FF00000U) && (l_info->mask_alpha == 0xC0000000U)) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_a2r10g10b10_to_bgra64;
+		}
+	}
+	return YABMP_OK;
+}
+
+/* gray levels equal to palette indices, a full palette is required so that out of range indices decode as with palette_gray */
+static int local_has_identity_gray_palette(const yabmp* reader)
+{
+	unsigned int i;
+	
+	if (reader->info2.num_palette != 256U) {
+		return 0;
+	}
+	for (i = 0U; i < 256U; ++i) {
+		if (reader->palette_gray[i] != i) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* builds weighted full range tables for blue, green & red bitfield samples & picks the luma kernel */
+static void local_setup_luma(yabmp* reader)
+{
+	unsigned int l_bits[3];
+	unsigned int c;
+	const yabmp_info* l_info = &(reader->info2);
+	
+	reader->out_mask[0] = l_info->mask_blue;
+	reader->out_mask[1] = l_info->mask_green;
+	reader->out_mask[2] = l_info->mask_red;
+	reader->out_mask[3] = 0U;
+	for (c = 0U; c < 3U; ++c) {
+		yabmp_uint32 l_value;
+		
+		yabmp_bitfield_get_shift_and_bits(reader->out_mask[c], &reader->out_shift[c], &l_bits[c]);
+		for (l_value = 0U; l_value < ((yabmp_uint32)1U << l_bits[c]); ++l_value) {
+			reader->luma_lut[c][l_value] = reader->luma_weights[c] * yabmp_bitfield_replicate(l_value, l_bits[c], 8U);
+		}
+	}
+	
+	if (l_info->bpp == 16U) {
+		reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_y8;
+	} else {
+		reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_to_y8;
+#if defined(YABMP_HAVE_X86_SIMD)
+		/* 8 bits channels on byte boundaries are weighted directly */
+		if ((yabmp_get_cpu_features() & YABMP_CPU_SSE41) && (l_bits[0] == 8U) && (l_bits[1] == 8U) && (l_bits[2] == 8U) &&
+			((reader->out_shift[0] & 7U) == 0U) && ((reader->out_shift[1] & 7U) == 0U) && ((reader->out_shift[2] & 7U) == 0U)) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_8888_to_y8_sse41;
+		}
+#endif
+	}
+}
+
+/* RLE opcodes are parsed in place (see local_rle_window_open), plain streams get a read-ahead buffer */
+static yabmp_status local_setup_rle_read_buffer(yabmp* reader)
+{
+	assert(reader != NULL);
+	
+	if ((reader->info2.compression != YABMP_COMPRESSION_RLE4) && (reader->info2.compression != YABMP_COMPRESSION_RLE8)) {
+		return YABMP_OK;
+	}
+	if ((reader->read_buffer != NULL) || (reader->input_data != NULL) || (reader->push_row_fn != NULL)) {
+		return YABMP_OK;
+	}
+	return yabmp_set_read_buffer_size(reader, YABMP_RLE_READ_BUFFER_SIZE);
+}
+
+static yabmp_status local_setup_read(yabmp* reader)
+{
+	yabmp_uint32 l_rle4_factor = 1U;
+	int l_alpha; /* expanded rows have 4 channels */
+	int l_gray_identity = 0; /* 8bpp indices are read as gray levels */
+	assert(reader != NULL);
+	
+	l_alpha = ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) || (reader->transforms & YABMP_TRANSFORM_FILL_ALPHA);
+	
+	if (reader->data_offset < reader->stream_offset) {
+		yabmp_send_error(reader, "Invalid data offset.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if (reader->data_offset > reader->stream_offset) {
+		YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, reader->data_offset - reader->stream_offset));
+	}
+	YABMP_SIMPLE_CHECK(local_setup_rle_read_buffer(reader));
+	
+	switch (reader->info2.compression) {
+		case YABMP_COMPRESSION_RLE4:
+			l_rle4_factor = 2U;
+			break;
+		case YABMP_COMPRESSION_NONE:
+		case YABMP_COMPRESSION_RLE8:
+		default:
+			break;
+	}
+	
+	if ((sizeof(size_t) > sizeof(yabmp_uint32)) && (reader->info2.rowbytes > 0xFFFFFFFFU)) {
+		yabmp_send_error(reader, "Would overflow.");
+		return YABMP_ERR_UNKNOW;
+	}
+	reader->input_row_bytes  = (yabmp_uint32)reader->info2.rowbytes;
+	
+	if (reader->input_row_bytes & ((l_rle4_factor - 1U) << 31U)) { /* l_rle4_factor is 1 or 2 */
+		yabmp_send_error(reader, "Would overflow.");
+		return YABMP_ERR_UNKNOW;
+	}
+	reader->input_step_bytes = reader->input_row_bytes * l_rle4_factor;
+	if (reader->input_step_bytes > (0xFFFFFFFFU - 3U)) {
+		yabmp_send_error(reader, "Would overflow.");
+		return YABMP_ERR_UNKNOW;
+	}
+	reader->input_step_bytes = (reader->input_step_bytes + 3U) & ~(yabmp_uint32)3U;
+	
+	/* region of interest */
+	if (reader->info2.bpp >= 8U) {
+		reader->region_offset_bytes = reader->region_x * (reader->info2.bpp / 8U);
+		reader->region_row_bytes = reader->region_width * (reader->info2.bpp / 8U);
+		reader->region_shift = 0U;
+		reader->transformed_row_bytes = reader->region_row_bytes; /* no transforms */
+	}
+	else {
+		yabmp_uint32 l_pixels_per_byte = 8U / reader->info2.bpp;
+		
+		reader->region_offset_bytes = reader->region_x / l_pixels_per_byte;
+		reader->region_shift = (unsigned int)(reader->region_x % l_pixels_per_byte) * reader->info2.bpp;
+		reader->region_row_bytes = (yabmp_uint32)(((size_t)(reader->region_x % l_pixels_per_byte) + (size_t)reader->region_width + l_pixels_per_byte - 1U) / l_pixels_per_byte);
+		reader->transformed_row_bytes = (yabmp_uint32)(((size_t)reader->region_width + l_pixels_per_byte - 1U) / l_pixels_per_byte); /* no transforms */
+	}
+	
+	if ((reader->transforms & (YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE)) == (YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE)) {
+		yabmp_send_error(reader, "Can't apply YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE transforms.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	/* First see if we must clear that (when format is already expanded), gray rows have no channel order */
+	if ((reader->info2.bpp == 24U) && !(reader->transforms & YABMP_TRANSFORM_GRAYSCALE)) {
+		if ((reader->output_format & YABMP_OUTPUT_RGB) || (reader->transforms & YABMP_TRANSFORM_FILL_ALPHA)) {
+			/* channels are swapped or alpha is added while copying */
+			reader->transforms |= YABMP_TRANSFORM_EXPAND;
+		} else {
+			reader->transforms &= ~YABMP_TRANSFORM_EXPAND;
+		}
+	}
+	
+	if ((reader->transforms & YABMP_TRANSFORM_GRAYSCALE) && (reader->info2.bpp <= 8U)) {
+		yabmp_prepare_palette_gray(reader);
+		/* no LUT & no intermediate row, 8bpp rows are read in place */
+		l_gray_identity = (reader->info2.bpp == 8U) && local_has_identity_gray_palette(reader);
+	}
+	
+	/* RLE rows are expanded while parsing runs, see local_rle_expand_row */
+	reader->rle_expand_bytes = 0U;
+	if ((reader->info2.compression == YABMP_COMPRESSION_RLE4) || (reader->info2.compression == YABMP_COMPRESSION_RLE8)) {
+		if ((reader->transforms & YABMP_TRANSFORM_EXPAND) != 0U) {
+			reader->rle_expand_bytes = l_alpha ? 4U : 3U;
+		}
+		else if (((reader->transforms & YABMP_TRANSFORM_GRAYSCALE) != 0U) && !l_gray_identity) {
+			reader->rle_expand_bytes = 1U;
+		}
+	}
+	
+	if ((reader->transforms & (YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_GRAYSCALE)) && !l_gray_identity) {
+		if (reader->rle_expand_bytes == 0U) {
+			reader->input_row = local_reserve(reader, reader->input_row, &reader->input_row_size, reader->input_step_bytes);
+			if (reader->input_row == NULL) {
+				return YABMP_ERR_ALLOCATION;
+			}
+		}
+		
+		if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
+			/* BGR or BGR(A) */
+			/* TODO 32bpp */
+			yabmp_uint32 l_Bpc = reader->info2.expanded_bps / 8U;
+			if (l_alpha) {
+				l_Bpc *= 4U;
+			} else {
+				l_Bpc *= 3U;
+			}
+			if (reader->region_width > (0xFFFFFFFFU / l_Bpc)) {
+				yabmp_send_error(reader, "Would overflow.");
+				return YABMP_ERR_UNKNOW;
+			}
+			reader->transformed_row_bytes = reader->region_width * l_Bpc;
+		}
+		else if (reader->transforms & YABMP_TRANSFORM_GRAYSCALE) {
+			reader->transformed_row_bytes = reader->region_width;
+		}
+	}
+	else if (reader->info2.compression == YABMP_COMPRESSION_RLE4) {
+		/* we need an intermediate buffer */
+		/* Overflow check already done for reader->input_step_bytes */
+		reader->rle_row = (yabmp_uint8*)local_reserve(reader, reader->rle_row, &reader->rle_row_size, (size_t)reader->input_row_bytes * 2U);
+		if (reader->rle_row == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+	}
+	else if ((reader->info2.compression == YABMP_COMPRESSION_RLE8) && local_has_column_region(reader)) {
+		/* full rows are decoded before extracting region columns */
+		reader->rle_row = (yabmp_uint8*)local_reserve(reader, reader->rle_row, &reader->rle_row_size, reader->input_row_bytes);
+		if (reader->rle_row == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+	}
+	else if (reader->region_shift != 0U) {
+		/* region pixels need to be realigned */
+		reader->input_row = local_reserve(reader, reader->input_row, &reader->input_row_size, reader->region_row_bytes);
+		if (reader->input_row == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+	}
+	
+	if (reader->transforms & YABMP_TRANSFORM_EXPAND) {
+		/* palette entries are packed on 4 bytes with opaque alpha */
+		unsigned int l_pal_bytes = l_alpha ? 4U : 3U;
+		
+		if (reader->info2.bpp == 1U) {
+			reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_pal1_to_bgra32 : (yabmp_transform_fn)yabmp_pal1_to_bgr24;
+			YABMP_SIMPLE_CHECK(local_setup_expand_lut(reader, l_pal_bytes));
+		}
+		else if (reader->info2.bpp == 2U) {
+			reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_pal2_to_bgra32 : (yabmp_transform_fn)yabmp_pal2_to_bgr24;
+			YABMP_SIMPLE_CHECK(local_setup_expand_lut(reader, l_pal_bytes));
+		}
+		else if ((reader->info2.bpp == 4U) && (reader->info2.compression != YABMP_COMPRESSION_RLE4)) {
+			reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_pal4_to_bgra32 : (yabmp_transform_fn)yabmp_pal4_to_bgr24;
+			YABMP_SIMPLE_CHECK(local_setup_expand_lut(reader, l_pal_bytes));
+		}
+		else if ((reader->info2.bpp == 8U) || (reader->info2.compression == YABMP_COMPRESSION_RLE4)) {
+			reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_pal8_to_bgra32 : (yabmp_transform_fn)yabmp_pal8_to_bgr24;
+#if defined(YABMP_HAVE_X86_SIMD)
+			{
+				unsigned int l_cpu_features = yabmp_get_cpu_features();
+				
+				if (l_cpu_features & YABMP_CPU_AVX2) {
+					reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_pal8_to_bgra32_avx2 : (yabmp_transform_fn)yabmp_pal8_to_bgr24_avx2;
+				}
+				else if ((l_cpu_features & YABMP_CPU_SSE41) && !l_alpha) {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_pal8_to_bgr24_sse41;
+				}
+			}
+#endif
+			yabmp_prepare_palette_packed(reader);
+		}
+		else if (reader->info2.bpp == 24U) {
+			reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_bgr24_to_bgra32 : (yabmp_transform_fn)yabmp_bgr24_to_rgb24;
+#if defined(YABMP_HAVE_X86_SIMD)
+			if (yabmp_get_cpu_features() & YABMP_CPU_SSE41) {
+				reader->transform_fn = l_alpha ? (yabmp_transform_fn)yabmp_bgr24_to_bgra32_sse41 : (yabmp_transform_fn)yabmp_bgr24_to_rgb24_sse41;
+			}
+#endif
+		}
+		else if (reader->info2.bpp == 16U) {
+			if (l_alpha) {
+				if (reader->info2.expanded_bps == 8U) {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgra32;
+				} else {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgra64;
+				}
+			} else {
+				if (reader->info2.expanded_bps == 8U) {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgr24;
+				} else {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf16u_to_bgr48;
+				}
+			}
+			YABMP_SIMPLE_CHECK(local_setup_bitfields(reader));
 		} else if (reader->info2.bpp == 32U) {
-			if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_ALPHA) {
+			if (l_alpha) {
 				if (reader->info2.expanded_bps == 8U) {
 					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_to_bgra32;
 				} else if (reader->info2.expanded_bps == 16U) {
@@ -1120,146 +2063,945 @@ static yabmp_status local_setup_read(yabmp* reader)
 					yabmp_send_error(reader, "Can't expand to %ubpp sample.", 4U * (unsigned int)reader->info2.expanded_bps);
 					return YABMP_ERR_UNKNOW;
 				}
-			} else  {
-				if (reader->info2.expanded_bps == 8U) {
-					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_to_bgr24;
-				} else if (reader->info2.expanded_bps == 16U) {
-					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_to_bgr48;
+			} else  {
+				if (reader->info2.expanded_bps == 8U) {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_to_bgr24;
+				} else if (reader->info2.expanded_bps == 16U) {
+					reader->transform_fn = (yabmp_transform_fn)yabmp_bf32u_to_bgr48;
+				} else {
+					/* TODO yabmp_bf32u_to_bgr96 ??? */
+					yabmp_send_error(reader, "Can't expand to %ubpp sample.", 3U * (unsigned int)reader->info2.expanded_bps);
+					return YABMP_ERR_UNKNOW;
+				}
+			}
+			YABMP_SIMPLE_CHECK(local_setup_bitfields(reader));
+		}
+	}
+	else if (reader->transforms & YABMP_TRANSFORM_GRAYSCALE) {
+		int l_has_weights = (reader->luma_weights[0] | reader->luma_weights[1] | reader->luma_weights[2]) != 0U;
+		
+		if (l_gray_identity) {
+			reader->transform_fn = NULL;
+		}
+		else if (reader->info2.bpp == 1U) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_pal1_to_y8;
+			YABMP_SIMPLE_CHECK(local_setup_expand_lut(reader, 1U));
+		}
+		else if (reader->info2.bpp == 2U) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_pal2_to_y8;
+			YABMP_SIMPLE_CHECK(local_setup_expand_lut(reader, 1U));
+		}
+		else if ((reader->info2.bpp == 4U) && (reader->info2.compression != YABMP_COMPRESSION_RLE4)) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_pal4_to_y8;
+			YABMP_SIMPLE_CHECK(local_setup_expand_lut(reader, 1U));
+		}
+		else if ((reader->info2.bpp == 8U) || (reader->info2.compression == YABMP_COMPRESSION_RLE4)) {
+			/* RLE4 rows are decoded one index per byte */
+			reader->transform_fn = (yabmp_transform_fn)yabmp_pal8_to_y8;
+		}
+		else if ((reader->info2.bpp == 24U) && l_has_weights) {
+			reader->transform_fn = (yabmp_transform_fn)yabmp_bgr24_to_y8;
+#if defined(YABMP_HAVE_X86_SIMD)
+			if (yabmp_get_cpu_features() & YABMP_CPU_SSE41) {
+				reader->transform_fn = (yabmp_transform_fn)yabmp_bgr24_to_y8_sse41;
+			}
+#endif
+		}
+		else if (((reader->info2.bpp == 16U) || (reader->info2.bpp == 32U)) && l_has_weights) {
+			if (reader->info2.expanded_bps > 8U) {
+				yabmp_send_error(reader, "Can't convert %ubpp samples to gray.", (unsigned int)reader->info2.expanded_bps);
+				return YABMP_ERR_UNKNOW;
+			}
+			local_setup_luma(reader);
+		} else {
+			/* TODO ??? */
+			yabmp_send_error(reader, "Can't expand palette from %ubpp sample.", (unsigned int)reader->info2.bpp);
+			return YABMP_ERR_UNKNOW;
+		}
+	}
+	
+	if (reader->rle_expand_bytes != 0U) {
+		/* palette colors or gray levels are ready, build run patterns */
+		reader->expand_lut = (yabmp_uint8*)local_reserve(reader, reader->expand_lut, &reader->expand_lut_size, 256U * 16U);
+		if (reader->expand_lut == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+		yabmp_prepare_rle_lut(reader, reader->rle_expand_bytes);
+	}
+	
+	return YABMP_OK;
+}
+
+/* row_wise is 0 when the whole image is read forward at once */
+static yabmp_status local_prepare_read(yabmp* reader, int row_wise)
+{
+	assert(reader != NULL);
+	
+	if ((reader->status & YABMP_STATUS_HAS_INFO) == 0U) {
+		yabmp_send_error(reader, "yabmp_read_info not called.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	if ((reader->status & YABMP_STATUS_HAS_VALID_INFO) == 0U) {
+		yabmp_send_error(reader, "Invalid info were found.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	if ((reader->status & YABMP_STATUS_HAS_LINES) == 0U) {
+		int l_backward = 0;
+		yabmp_uint32 l_first_row = reader->region_y; /* first row to read in stream order */
+		
+		/* setup reading */
+		YABMP_SIMPLE_CHECK(local_setup_read(reader));
+		
+		if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
+			if (row_wise) {
+				/* rows will be read backward, starting with the last one */
+				if (reader->seek_fn == NULL) {
+					yabmp_send_error(reader, "Scan direction change is only supported with a non NULL seek function when reading rows. Use yabmp_read_image.");
+					return YABMP_ERR_UNKNOW;
+				}
+				if ((reader->info2.compression != YABMP_COMPRESSION_NONE) && (reader->row_index == NULL)) {
+					yabmp_send_error(reader, "Scan direction change is only supported for YABMP_COMPRESSION_NONE when reading rows. Use yabmp_read_image or yabmp_build_row_index.");
+					return YABMP_ERR_UNKNOW;
+				}
+				l_first_row = reader->info2.height - 1U - reader->region_y;
+				l_backward = 1;
+			}
+			else {
+				l_first_row = reader->info2.height - reader->region_y - reader->region_height;
+			}
+		}
+		
+		if (reader->info2.compression == YABMP_COMPRESSION_NONE) {
+			YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, reader->input_step_bytes * l_first_row));
+		}
+		else if (reader->row_index != NULL) {
+			YABMP_SIMPLE_CHECK(local_seek_row(reader, l_first_row));
+		}
+		else {
+			/* fast-forward without decoding pixels */
+			while (l_first_row > 0U) {
+				YABMP_SIMPLE_CHECK(local_rle_skip_row(reader));
+				l_first_row--;
+			}
+		}
+		yabmp_stream_access_hint(reader, l_backward);
+		reader->status |= YABMP_STATUS_HAS_LINES;
+	}
+	return YABMP_OK;
+}
+
+/* positions the stream at the start of a row, row is in stream order */
+static yabmp_status local_seek_row(yabmp* reader, yabmp_uint32 row)
+{
+	assert(reader != NULL);
+	assert(row < reader->info2.height);
+	
+	if (reader->row_index != NULL) {
+		const yabmp_uint32* l_entry = reader->row_index + (size_t)row * YABMP_ROW_INDEX_VALUES_PER_ROW;
+		
+		YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, l_entry[0]));
+		reader->rle_skip_x = (unsigned int)l_entry[1];
+		reader->rle_skip_y = (unsigned int)l_entry[2];
+		reader->next_row = row;
+	}
+	else {
+		if (row > ((0xFFFFFFFFU - reader->data_offset) / reader->input_step_bytes)) {
+			yabmp_send_error(reader, "Would overflow.");
+			return YABMP_ERR_UNKNOW;
+		}
+		YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, reader->data_offset + row * reader->input_step_bytes));
+	}
+	return YABMP_OK;
+}
+
+static yabmp_status local_next_row(yabmp* reader)
+{
+	assert(reader != NULL);
+	
+	if (reader->row_index != NULL) {
+		if ((reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) == 0U) {
+			/* decoder state is already right */
+			reader->next_row++;
+		}
+		else if (reader->next_row > 0U) {
+			YABMP_SIMPLE_CHECK(local_seek_row(reader, reader->next_row - 1U));
+		}
+	}
+	else if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
+		if (reader->stream_offset >= 2U * reader->input_step_bytes) {
+			/* not last line to read */
+			YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, reader->stream_offset - 2U * reader->input_step_bytes));
+		}
+	}
+	return YABMP_OK;
+}
+
+/* reads region bytes of the uncompressed row at current stream position */
+static yabmp_status local_read_uncompressed_row(yabmp* reader, yabmp_uint8* row)
+{
+	yabmp_uint8* l_dst = row;
+	yabmp_uint32 l_read_bytes = reader->region_row_bytes;
+	
+	assert(reader != NULL);
+	assert(row != NULL);
+	
+	if (reader->region_shift != 0U) {
+		/* region pixels are realigned from the intermediate row */
+		l_dst = (yabmp_uint8*)reader->input_row;
+	}
+	else if ((reader->transform_fn != NULL) && !local_has_column_region(reader)) {
+		/* intermediate row holds a whole step, read padding along */
+		l_read_bytes = reader->input_step_bytes;
+	}
+	
+	YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, reader->region_offset_bytes));
+	YABMP_SIMPLE_CHECK(yabmp_stream_read(reader, l_dst, l_read_bytes));
+#if defined(YABMP_BIG_ENDIAN)
+	if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) {
+		if (reader->info2.bpp == 16U) {
+			yabmp_swap16u(reader, l_dst);
+		} else {
+			yabmp_swap32u(reader, l_dst);
+		}
+	}
+#endif
+	if (reader->region_shift != 0U) {
+		yabmp_uint32 l_pixels_per_byte = 8U / reader->info2.bpp;
+		
+		local_shift_row(l_dst, row, reader->region_row_bytes, (reader->region_width + l_pixels_per_byte - 1U) / l_pixels_per_byte, reader->region_shift);
+	}
+	return yabmp_stream_skip(reader, reader->input_step_bytes - reader->region_offset_bytes - l_read_bytes);
+}
+
+/* decodes the row at current stream position */
+static yabmp_status local_decode_row(yabmp* reader, void* row)
+{
+	assert(reader != NULL);
+	assert(row != NULL);
+	
+	if (reader->rle_expand_bytes != 0U) {
+		/* palette colors are written while parsing runs */
+		YABMP_SIMPLE_CHECK(local_rle_expand_row(reader, (yabmp_uint8*)row));
+	}
+	else if (reader->transform_fn != NULL) {
+		const yabmp_uint8* l_src = (const yabmp_uint8*)reader->input_row;
+		
+		switch (reader->info2.compression) {
+			case YABMP_COMPRESSION_RLE8:
+				YABMP_SIMPLE_CHECK(local_rle8_decode_row(reader, reader->input_row));
+				l_src += reader->region_x;
+				break;
+			case YABMP_COMPRESSION_RLE4:
+				YABMP_SIMPLE_CHECK(local_rle4_decode_row(reader, reader->input_row, 0));
+				l_src += reader->region_x;
+				break;
+			default:
+				YABMP_SIMPLE_CHECK(local_read_uncompressed_row(reader, reader->input_row));
+				break;
+		}
+		reader->transform_fn(reader, l_src, row);
+	}
+	else {
+		switch (reader->info2.compression) {
+			case YABMP_COMPRESSION_RLE8:
+				if (local_has_column_region(reader)) {
+					/* only some columns are needed */
+					YABMP_SIMPLE_CHECK(local_rle8_decode_row(reader, reader->rle_row));
+					memcpy(row, reader->rle_row + reader->region_x, reader->region_width);
+				}
+				else {
+					YABMP_SIMPLE_CHECK(local_rle8_decode_row(reader, row));
+				}
+				break;
+			case YABMP_COMPRESSION_RLE4:
+				YABMP_SIMPLE_CHECK(local_rle4_decode_row(reader, row, 1));
+				break;
+			default:
+				YABMP_SIMPLE_CHECK(local_read_uncompressed_row(reader, row));
+				break;
+		}
+	}
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_read_row, (yabmp* reader, void* row, size_t row_size))
+{	
+	YABMP_CHECK_READER(reader);
+	
+	if (row == NULL) {
+		yabmp_send_error(reader, "NULL info or NULL row.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	YABMP_SIMPLE_CHECK(local_prepare_read(reader, 1));
+	
+	if (row_size < (size_t)reader->transformed_row_bytes) {
+		yabmp_send_error(reader, "Invalid row size.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	YABMP_SIMPLE_CHECK(local_decode_row(reader, row));
+	
+	return local_next_row(reader);
+}
+
+YABMP_API(yabmp_status, yabmp_read_row_at, (yabmp* reader, yabmp_uint32 row_index, void* row, size_t row_size))
+{
+	yabmp_uint32 l_row; /* row index in stream order */
+	
+	YABMP_CHECK_READER(reader);
+	
+	if (row == NULL) {
+		yabmp_send_error(reader, "NULL row.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	YABMP_SIMPLE_CHECK(local_prepare_read(reader, 1));
+	
+	if ((reader->seek_fn == NULL) || ((reader->info2.compression != YABMP_COMPRESSION_NONE) && (reader->row_index == NULL))) {
+		yabmp_send_error(reader, "yabmp_read_row_at requires a non NULL seek function and YABMP_COMPRESSION_NONE or a row index.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if (row_index >= reader->region_height) {
+		yabmp_send_error(reader, "Invalid row index %" YABMP_PRIu32 ".", row_index);
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	if (row_size < (size_t)reader->transformed_row_bytes) {
+		yabmp_send_error(reader, "Invalid row size.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	l_row = reader->region_y + row_index;
+	if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
+		l_row = reader->info2.height - 1U - l_row;
+	}
+	YABMP_SIMPLE_CHECK(local_seek_row(reader, l_row));
+	YABMP_SIMPLE_CHECK(local_decode_row(reader, row));
+	
+	/* sequential reading goes on with the following row */
+	return local_next_row(reader);
+}
+
+static yabmp_status local_read_rows(yabmp* reader, yabmp_uint8* rows, size_t stride, yabmp_uint32 count)
+{
+	yabmp_uint32 i;
+	
+	assert(reader != NULL);
+	assert(rows != NULL);
+	assert(count > 0U);
+	
+	if ((reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) && (reader->info2.compression == YABMP_COMPRESSION_NONE)) {
+		/* Rows are contiguous in the stream, in reverse order. Read them forward, with only one seek. */
+		yabmp_uint32 l_first_row_offset;
+		
+		if ((reader->stream_offset < reader->data_offset) || (((reader->stream_offset - reader->data_offset) / reader->input_step_bytes) < (count - 1U))) {
+			yabmp_send_error(reader, "Can't read %" YABMP_PRIu32 " rows, not enough rows left.", count);
+			return YABMP_ERR_UNKNOW;
+		}
+		l_first_row_offset = reader->stream_offset - (count - 1U) * reader->input_step_bytes;
+		YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, l_first_row_offset));
+		for (i = count; i > 0U; --i) {
+			YABMP_SIMPLE_CHECK(local_decode_row(reader, rows + (size_t)(i - 1U) * stride));
+		}
+		if (l_first_row_offset >= (reader->data_offset + reader->input_step_bytes)) {
+			/* not last line to read */
+			YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, l_first_row_offset - reader->input_step_bytes));
+		}
+	}
+	else if ((reader->transform_fn == NULL) && (reader->info2.compression == YABMP_COMPRESSION_NONE) && !local_has_column_region(reader) && (stride == (size_t)reader->input_step_bytes) && (count <= (0xFFFFFFFFU / reader->input_step_bytes))) {
+		/* Destination has the same layout as the stream, read all rows at once (last row padding excluded) */
+		YABMP_SIMPLE_CHECK(yabmp_stream_read(reader, rows, (size_t)(count - 1U) * stride + (size_t)reader->input_row_bytes));
+#if defined(YABMP_BIG_ENDIAN)
+		if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) {
+			for (i = 0U; i < count; ++i) {
+				if (reader->info2.bpp == 16U) {
+					yabmp_swap16u(reader, rows + (size_t)i * stride);
 				} else {
-					/* TODO yabmp_bf32u_to_bgr96 ??? */
-					yabmp_send_error(reader, "Can't expand to %ubpp sample.", 3U * (unsigned int)reader->info2.expanded_bps);
-					return YABMP_ERR_UNKNOW;
+					yabmp_swap32u(reader, rows + (size_t)i * stride);
 				}
 			}
 		}
+#endif
+		YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, (yabmp_uint32)(reader->input_step_bytes - reader->input_row_bytes)));
+	}
+	else {
+		for (i = 0U; i < count; ++i) {
+			YABMP_SIMPLE_CHECK(local_decode_row(reader, rows + (size_t)i * stride));
+			YABMP_SIMPLE_CHECK(local_next_row(reader));
+		}
+	}
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_read_rows, (yabmp* reader, void* rows, size_t stride, yabmp_uint32 count))
+{
+	YABMP_CHECK_READER(reader);
+	
+	if (rows == NULL) {
+		yabmp_send_error(reader, "NULL rows.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	YABMP_SIMPLE_CHECK(local_prepare_read(reader, 1));
+	
+	if (stride < (size_t)reader->transformed_row_bytes) {
+		yabmp_send_error(reader, "Invalid stride.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if (count == 0U) {
+		return YABMP_OK;
+	}
+	
+	return local_read_rows(reader, (yabmp_uint8*)rows, stride, count);
+}
+
+typedef struct local_band_context_struct
+{
+	const yabmp* reader;
+	yabmp_uint8* image;
+	size_t       stride;
+	yabmp_uint8* scratch; /* one intermediate row per band, NULL when not needed */
+	int          copy_rows; /* memory input rows are copied to scratch before being transformed */
+	yabmp_uint8* failed;  /* one read failure flag per band */
+	unsigned int band_count;
+} local_band_context;
+
+/* decodes one band of rows straight from the memory input or positional stream, can run concurrently with other bands */
+static void local_decode_band(void* context, unsigned int band_index)
+{
+	const local_band_context* l_context = (const local_band_context*)context;
+	const yabmp* l_reader = l_context->reader;
+	yabmp_uint8* l_scratch = NULL;
+	yabmp_uint32 l_rows_per_band = l_reader->region_height / l_context->band_count;
+	yabmp_uint32 l_extra_rows = l_reader->region_height % l_context->band_count;
+	yabmp_uint32 l_first, l_last, i;
+	
+	l_first = band_index * l_rows_per_band + ((band_index < l_extra_rows) ? band_index : l_extra_rows);
+	l_last = l_first + l_rows_per_band + ((band_index < l_extra_rows) ? 1U : 0U);
+	
+	if (l_context->scratch != NULL) {
+		l_scratch = l_context->scratch + (size_t)band_index * l_reader->region_row_bytes;
+	}
+	
+	for (i = l_first; i < l_last; ++i) {
+		yabmp_uint32 l_row = l_reader->region_y + i; /* row index in stream order */
+		const yabmp_uint8* l_src;
+		yabmp_uint8* l_dst = l_context->image + (size_t)i * l_context->stride;
+		
+		if (l_reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
+			l_row = l_reader->info2.height - 1U - l_row;
+		}
+		if (l_reader->input_data != NULL) {
+			l_src = l_reader->input_data + l_reader->data_offset + (size_t)l_row * l_reader->input_step_bytes + l_reader->region_offset_bytes;
+			if (l_context->copy_rows) {
+				memcpy(l_scratch, l_src, l_reader->region_row_bytes);
+				l_src = l_scratch;
+			}
+		}
+		else {
+			/* offset can't overflow, checked in local_read_image_parallel */
+			yabmp_uint32 l_offset = l_reader->data_offset + l_row * l_reader->input_step_bytes + l_reader->region_offset_bytes;
+			yabmp_uint8* l_tmp = (l_scratch != NULL) ? l_scratch : l_dst;
+			
+			if (l_reader->read_at_fn(l_reader->read_at_context, l_offset, l_tmp, l_reader->region_row_bytes) != l_reader->region_row_bytes) {
+				l_context->failed[band_index] = 1U;
+				return;
+			}
+			l_src = l_tmp;
+		}
+		
+		if (l_reader->region_shift != 0U) {
+			yabmp_uint32 l_pixels_per_byte = 8U / l_reader->info2.bpp;
+			yabmp_uint8* l_tmp = (l_reader->transform_fn != NULL) ? l_scratch : l_dst;
+			
+			local_shift_row(l_src, l_tmp, l_reader->region_row_bytes, (l_reader->region_width + l_pixels_per_byte - 1U) / l_pixels_per_byte, l_reader->region_shift);
+			l_src = l_tmp;
+		}
+#if defined(YABMP_BIG_ENDIAN)
+		if ((l_reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) {
+			yabmp_uint8* l_tmp = (l_reader->transform_fn != NULL) ? l_scratch : l_dst;
+			
+			if (l_tmp != l_src) {
+				memcpy(l_tmp, l_src, l_reader->region_row_bytes);
+			}
+			if (l_reader->info2.bpp == 16U) {
+				yabmp_swap16u(l_reader, (yabmp_uint16*)l_tmp);
+			} else {
+				yabmp_swap32u(l_reader, (yabmp_uint32*)l_tmp);
+			}
+			l_src = l_tmp;
+		}
+#endif
+		if (l_reader->transform_fn != NULL) {
+			l_reader->transform_fn(l_reader, l_src, l_dst);
+		}
+		else if (l_src != l_dst) {
+			memcpy(l_dst, l_src, l_reader->transformed_row_bytes);
+		}
+	}
+}
+
+/* sets decoded to 0 when sequential decoding must be used */
+static yabmp_status local_read_image_parallel(yabmp* reader, yabmp_uint8* image, size_t stride, int* decoded)
+{
+	local_band_context l_context;
+	yabmp_uint32 l_first_row; /* lowest row in stream order */
+	yabmp_uint32 l_row_count;
+	size_t l_row_end; /* end of the first row region bytes in input data */
+	int l_need_scratch = 0;
+	int l_copy_rows = 0;
+	yabmp_status l_status = YABMP_OK;
+	unsigned int i;
+	
+	assert(reader != NULL);
+	assert(image != NULL);
+	assert(decoded != NULL);
+	
+	*decoded = 0;
+	if ((reader->task_count <= 1U) || ((reader->input_data == NULL) && (reader->read_at_fn == NULL)) || (reader->info2.compression != YABMP_COMPRESSION_NONE)) {
+		return YABMP_OK;
+	}
+	
+	/* all rows must be available, sequential decoding reports errors otherwise */
+	l_first_row = reader->region_y;
+	if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
+		l_first_row = reader->info2.height - reader->region_y - reader->region_height;
+	}
+	l_row_count = reader->region_height;
+	if (reader->input_data != NULL) {
+		l_row_end = (size_t)reader->data_offset + (size_t)reader->region_offset_bytes + (size_t)reader->region_row_bytes;
+		if ((l_row_end > reader->input_data_size) || ((size_t)(l_first_row + l_row_count - 1U) > ((reader->input_data_size - l_row_end) / (size_t)reader->input_step_bytes))) {
+			return YABMP_OK;
+		}
+		/* bitfield kernels load 16/32 bits samples, row steps & region offsets keep the alignment of the first row */
+		if ((reader->transform_fn != NULL) && ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) && (((size_t)(reader->input_data + reader->data_offset) % (reader->info2.bpp / 8U)) != 0U)) {
+			l_copy_rows = 1;
+			l_need_scratch = 1;
+		}
+	}
+	else {
+		/* positional reads report truncated input, only offsets must fit */
+		l_row_end = 0xFFFFFFFFU - (size_t)reader->data_offset - (size_t)reader->region_offset_bytes;
+		if ((size_t)(l_first_row + l_row_count - 1U) > (l_row_end / (size_t)reader->input_step_bytes)) {
+			return YABMP_OK;
+		}
+		/* rows are read in an intermediate buffer unless they can be read straight into image */
+		if ((reader->transform_fn != NULL) || (reader->region_shift != 0U) || (reader->region_row_bytes > reader->transformed_row_bytes)) {
+			l_need_scratch = 1;
+		}
+	}
+	
+	l_context.reader = reader;
+	l_context.image = image;
+	l_context.stride = stride;
+	l_context.scratch = NULL;
+	l_context.copy_rows = l_copy_rows;
+	l_context.failed = NULL;
+	l_context.band_count = reader->task_count;
+	if (l_context.band_count > l_row_count) {
+		l_context.band_count = (unsigned int)l_row_count;
+	}
+	
+	if ((reader->transform_fn != NULL) && (reader->region_shift != 0U)) {
+		l_need_scratch = 1;
+	}
+#if defined(YABMP_BIG_ENDIAN)
+	if ((reader->transform_fn != NULL) && ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS)) {
+		l_need_scratch = 1;
+	}
+#endif
+	if (l_need_scratch) {
+		l_context.scratch = (yabmp_uint8*)yabmp_malloc(reader, (size_t)l_context.band_count * reader->region_row_bytes);
+		if (l_context.scratch == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+	}
+	l_context.failed = (yabmp_uint8*)yabmp_malloc(reader, (size_t)l_context.band_count);
+	if (l_context.failed == NULL) {
+		yabmp_free(reader, l_context.scratch);
+		return YABMP_ERR_ALLOCATION;
+	}
+	memset(l_context.failed, 0, (size_t)l_context.band_count);
+	
+	yabmp_parallel_for(reader, l_context.band_count, local_decode_band, &l_context);
+	*decoded = 1;
+	
+	for (i = 0U; i < l_context.band_count; ++i) {
+		if (l_context.failed[i]) {
+			yabmp_send_error(reader, "Failed to read rows.");
+			l_status = YABMP_ERR_UNKNOW;
+			break;
+		}
+	}
+	
+	yabmp_free(reader, l_context.failed);
+	yabmp_free(reader, l_context.scratch);
+	return l_status;
+}
+
+YABMP_API(yabmp_status, yabmp_read_image, (yabmp* reader, void* image, size_t stride))
+{
+	int l_decoded = 0;
+	
+	YABMP_CHECK_READER(reader);
+	
+	if (image == NULL) {
+		yabmp_send_error(reader, "NULL image.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	if ((reader->status & YABMP_STATUS_HAS_LINES) != 0U) {
+		yabmp_send_error(reader, "yabmp_read_image can't be used once rows have been read.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	YABMP_SIMPLE_CHECK(local_prepare_read(reader, 0));
+	
+	if (stride < (size_t)reader->transformed_row_bytes) {
+		yabmp_send_error(reader, "Invalid stride.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	YABMP_SIMPLE_CHECK(local_read_image_parallel(reader, (yabmp_uint8*)image, stride, &l_decoded));
+	if (l_decoded) {
+		return YABMP_OK;
+	}
+	
+	if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
+		/* Always read forward, store rows starting from the bottom of the image */
+		yabmp_uint8* l_row = (yabmp_uint8*)image + (size_t)(reader->region_height - 1U) * stride;
+		yabmp_uint32 i;
+		
+		for (i = 0U; i < reader->region_height; ++i) {
+			YABMP_SIMPLE_CHECK(local_decode_row(reader, l_row));
+			l_row -= stride;
+		}
+	}
+	else {
+		YABMP_SIMPLE_CHECK(local_read_rows(reader, (yabmp_uint8*)image, stride, reader->region_height));
+	}
+	return YABMP_OK;
+}
+
+#define LOCAL_PUSH_STEP_INFO    0
+#define LOCAL_PUSH_STEP_PREPARE 1
+#define LOCAL_PUSH_STEP_ROW     2
+
+/* runs one decoding step on pushed data, rolls back when more data is needed */
+static yabmp_status local_push_step(yabmp* reader, int step, int* starved)
+{
+	yabmp_status l_status = YABMP_OK;
+	yabmp_uint32 l_offset = reader->stream_offset;
+	unsigned int l_skip_x = reader->rle_skip_x;
+	unsigned int l_skip_y = reader->rle_skip_y;
+	
+	assert(reader != NULL);
+	assert(starved != NULL);
+	
+	reader->push_starved = 0;
+	switch (step) {
+		case LOCAL_PUSH_STEP_INFO:
+			l_status = yabmp_read_info(reader, reader->push_info);
+			break;
+		case LOCAL_PUSH_STEP_PREPARE:
+			l_status = local_prepare_read(reader, 1);
+			break;
+		default:
+			l_status = local_decode_row(reader, reader->push_row);
+			if (l_status == YABMP_OK) {
+				l_status = local_next_row(reader);
+			}
+			break;
+	}
+	
+	*starved = reader->push_starved;
+	if (reader->push_starved) {
+		/* the whole step will be done again */
+		reader->stream_offset = l_offset;
+		reader->rle_skip_x = l_skip_x;
+		reader->rle_skip_y = l_skip_y;
+		reader->push_starved = 0;
+		l_status = YABMP_OK;
+	}
+	return l_status;
+}
+
+YABMP_API(yabmp_status, yabmp_push_data, (yabmp* reader, const void* data, size_t data_size))
+{
+	int l_starved = 0;
+	
+	YABMP_CHECK_READER(reader);
+	
+	if ((data == NULL) && (data_size > 0U)) {
+		yabmp_send_error(reader, "NULL data.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	if (reader->push_row_fn == NULL) {
+		yabmp_send_error(reader, "Push input not set.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if (((reader->status & YABMP_STATUS_HAS_LINES) != 0U) && (reader->push_row_count >= reader->region_height)) {
+		/* all rows were decoded */
+		return YABMP_OK;
+	}
+	
+	YABMP_SIMPLE_CHECK(yabmp_stream_push(reader, (const yabmp_uint8*)data, data_size));
+	
+	if ((reader->status & YABMP_STATUS_HAS_INFO) == 0U) {
+		/* wait for headers up to image data offset, they're parsed only once in most cases */
+		/* data offset isn't trusted, no more than headers, bitfields & a full palette are waited for */
+		yabmp_uint32 l_wait;
+		yabmp_uint32 l_header_size;
+		
+		if (reader->push_buffer_len < 18U) {
+			return YABMP_OK;
+		}
+		l_wait = local_get_le_32u(reader->push_buffer + 10U);
+		l_header_size = local_get_le_32u(reader->push_buffer + 14U);
+		if (l_header_size > 124U) {
+			l_header_size = 124U;
+		}
+		if (l_wait > (14U + l_header_size + 16U + 256U * 4U)) {
+			l_wait = 14U + l_header_size + 16U + 256U * 4U;
+		}
+		if (reader->push_buffer_len < (size_t)l_wait) {
+			return YABMP_OK;
+		}
+		YABMP_SIMPLE_CHECK(local_push_step(reader, LOCAL_PUSH_STEP_INFO, &l_starved));
+		if (l_starved) {
+			return YABMP_OK;
+		}
+		if (reader->push_info_fn != NULL) {
+			YABMP_SIMPLE_CHECK(reader->push_info_fn(reader->push_context, reader, reader->push_info));
+		}
 	}
-	else if (reader->transforms & YABMP_TRANSFORM_GRAYSCALE) {
-		if (reader->info2.bpp == 1U) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal1_to_y8;
+	if ((reader->status & YABMP_STATUS_HAS_LINES) == 0U) {
+		if (reader->stream_offset < reader->data_offset) {
+			/* bytes up to image data are dropped as they arrive */
+			size_t l_count = reader->push_buffer_len - (size_t)(reader->stream_offset - reader->push_buffer_offset);
+			
+			if (l_count > (size_t)(reader->data_offset - reader->stream_offset)) {
+				l_count = (size_t)(reader->data_offset - reader->stream_offset);
+			}
+			reader->stream_offset += (yabmp_uint32)l_count;
+			if (reader->stream_offset < reader->data_offset) {
+				return YABMP_OK;
+			}
 		}
-		else if (reader->info2.bpp == 2U) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal2_to_y8;
+		YABMP_SIMPLE_CHECK(local_push_step(reader, LOCAL_PUSH_STEP_PREPARE, &l_starved));
+		if (l_starved) {
+			return YABMP_OK;
 		}
-		else if (reader->info2.bpp == 4U) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal4_to_y8;
+	}
+	if (reader->push_row_size < (size_t)reader->transformed_row_bytes) {
+		reader->push_row = local_reserve(reader, reader->push_row, &reader->push_row_size, reader->transformed_row_bytes);
+		if (reader->push_row == NULL) {
+			return YABMP_ERR_ALLOCATION;
 		}
-		else if (reader->info2.bpp == 8U) {
-			reader->transform_fn = (yabmp_transform_fn)yabmp_pal8_to_y8;
-		} else {
-			/* TODO ??? */
-			yabmp_send_error(reader, "Can't expand palette from %ubpp sample.", (unsigned int)reader->info2.bpp);
-			return YABMP_ERR_UNKNOW;
+	}
+	while (reader->push_row_count < reader->region_height) {
+		YABMP_SIMPLE_CHECK(local_push_step(reader, LOCAL_PUSH_STEP_ROW, &l_starved));
+		if (l_starved) {
+			break;
 		}
+		YABMP_SIMPLE_CHECK(reader->push_row_fn(reader->push_context, reader->push_row_count, reader->push_row));
+		reader->push_row_count++;
 	}
+	return YABMP_OK;
+}
+
+/* checks row index can be built or set */
+static yabmp_status local_check_row_index(yabmp* reader)
+{
+	assert(reader != NULL);
 	
+	if ((reader->status & YABMP_STATUS_HAS_VALID_INFO) == 0U) {
+		yabmp_send_error(reader, "yabmp_read_info not called or invalid info were found.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((reader->status & YABMP_STATUS_HAS_LINES) != 0U) {
+		yabmp_send_error(reader, "Row index can't be changed once rows have been read.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((reader->info2.compression != YABMP_COMPRESSION_RLE4) && (reader->info2.compression != YABMP_COMPRESSION_RLE8)) {
+		yabmp_send_error(reader, "Row index is only supported for YABMP_COMPRESSION_RLE4 and YABMP_COMPRESSION_RLE8.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if (reader->seek_fn == NULL) {
+		yabmp_send_error(reader, "Row index requires a non NULL seek function.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((size_t)reader->info2.height > (((size_t)-1) / (YABMP_ROW_INDEX_VALUES_PER_ROW * sizeof(yabmp_uint32)))) {
+		yabmp_send_error(reader, "Would overflow.");
+		return YABMP_ERR_UNKNOW;
+	}
 	return YABMP_OK;
 }
 
-YABMP_API(yabmp_status, yabmp_read_row, (yabmp* reader, void* row, size_t row_size))
-{	
+YABMP_API(yabmp_status, yabmp_build_row_index, (yabmp* reader))
+{
+	yabmp_status  l_status = YABMP_OK;
+	yabmp_uint32* l_index = NULL;
+	yabmp_uint32  l_stream_offset;
+	yabmp_uint32  i;
+	
 	YABMP_CHECK_READER(reader);
+	YABMP_SIMPLE_CHECK(local_check_row_index(reader));
+	YABMP_SIMPLE_CHECK(local_setup_rle_read_buffer(reader));
 	
-	if (row == NULL) {
-		yabmp_send_error(reader, "NULL info or NULL row.");
-		return YABMP_ERR_INVALID_ARGS;
+	l_index = (yabmp_uint32*)yabmp_malloc(reader, (size_t)reader->info2.height * YABMP_ROW_INDEX_VALUES_PER_ROW * sizeof(yabmp_uint32));
+	if (l_index == NULL) {
+		return YABMP_ERR_ALLOCATION;
 	}
 	
-	if ((reader->status & YABMP_STATUS_HAS_INFO) == 0U) {
-		yabmp_send_error(reader, "yabmp_read_info not called.");
-		return YABMP_ERR_UNKNOW;
+	/* one pass over the whole stream, pixels are not decoded */
+	l_stream_offset = reader->stream_offset;
+	l_status = yabmp_stream_seek(reader, reader->data_offset);
+	if (l_status != YABMP_OK) {
+		goto BADEND;
 	}
-	
-	if ((reader->status & YABMP_STATUS_HAS_VALID_INFO) == 0U) {
-		yabmp_send_error(reader, "Invalid info were found.");
-		return YABMP_ERR_UNKNOW;
+	reader->rle_skip_x = 0U;
+	reader->rle_skip_y = 0U;
+	for (i = 0U; i < reader->info2.height; ++i) {
+		yabmp_uint32* l_entry = l_index + (size_t)i * YABMP_ROW_INDEX_VALUES_PER_ROW;
+		
+		l_entry[0] = reader->stream_offset;
+		l_entry[1] = (yabmp_uint32)reader->rle_skip_x;
+		l_entry[2] = (yabmp_uint32)reader->rle_skip_y;
+		l_status = local_rle_skip_row(reader);
+		if (l_status != YABMP_OK) {
+			goto BADEND;
+		}
+	}
+	reader->rle_skip_x = 0U;
+	reader->rle_skip_y = 0U;
+	l_status = yabmp_stream_seek(reader, l_stream_offset);
+	if (l_status != YABMP_OK) {
+		goto BADEND;
 	}
 	
-	if ((reader->status & YABMP_STATUS_HAS_LINES) == 0U) {
-		/* setup reading */
-		YABMP_SIMPLE_CHECK(local_setup_read(reader));
+	yabmp_free(reader, reader->row_index);
+	reader->row_index = l_index;
+	l_index = NULL;
+BADEND:
+	if (l_index != NULL) {
+		reader->rle_skip_x = 0U;
+		reader->rle_skip_y = 0U;
+		yabmp_free(reader, l_index);
 	}
+	return l_status;
+}
+
+YABMP_API(yabmp_status, yabmp_get_row_index, (const yabmp* reader, const yabmp_uint32** index, size_t* index_len))
+{
+	YABMP_CHECK_READER(reader);
 	
-	if (row_size < (size_t)reader->transformed_row_bytes) {
-		yabmp_send_error(reader, "Invalid row size.");
+	if ((index == NULL) || (index_len == NULL)) {
+		yabmp_send_error(reader, "NULL index or NULL index_len.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	if (reader->row_index == NULL) {
+		yabmp_send_error(reader, "No row index.");
 		return YABMP_ERR_UNKNOW;
 	}
+	*index = reader->row_index;
+	*index_len = (size_t)reader->info2.height * YABMP_ROW_INDEX_VALUES_PER_ROW;
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_row_index, (yabmp* reader, const yabmp_uint32* index, size_t index_len))
+{
+	yabmp_uint32* l_index = NULL;
+	yabmp_uint32  l_previous_offset;
+	yabmp_uint32  i;
 	
-	if (reader->transform_fn != NULL) {
-		switch (reader->info2.compression) {
-			case YABMP_COMPRESSION_RLE8:
-				YABMP_SIMPLE_CHECK(local_rle8_decode_row(reader, reader->input_row));
-				break;
-			case YABMP_COMPRESSION_RLE4:
-				YABMP_SIMPLE_CHECK(local_rle4_decode_row(reader, reader->input_row, 0));
-				break;
-		default:
-				YABMP_SIMPLE_CHECK(yabmp_stream_read(reader, reader->input_row, reader->input_step_bytes));
-#if defined(YABMP_BIG_ENDIAN)
-				if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) {
-					if (reader->info2.bpp == 16U) {
-						yabmp_swap16u(reader, reader->input_row);
-					} else {
-						yabmp_swap32u(reader, reader->input_row);
-					}
-				}
-#endif
-				break;
-		}
-		reader->transform_fn(reader, reader->input_row, row);
+	YABMP_CHECK_READER(reader);
+	
+	if (index == NULL) {
+		yabmp_send_error(reader, "NULL index.");
+		return YABMP_ERR_INVALID_ARGS;
 	}
-	else {
-		switch (reader->info2.compression) {
-			case YABMP_COMPRESSION_RLE8:
-				YABMP_SIMPLE_CHECK(local_rle8_decode_row(reader, row));
-				break;
-			case YABMP_COMPRESSION_RLE4:
-				YABMP_SIMPLE_CHECK(local_rle4_decode_row(reader, row, 1));
-				break;
-			default:
-				YABMP_SIMPLE_CHECK(yabmp_stream_read(reader, row, reader->input_row_bytes));
-#if defined(YABMP_BIG_ENDIAN)
-				if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) {
-					if (reader->info2.bpp == 16U) {
-						yabmp_swap16u(reader, row);
-					} else {
-						yabmp_swap32u(reader, row);
-					}
-				}
-#endif
-				YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, (yabmp_uint32)(reader->input_step_bytes - reader->input_row_bytes)));
-				break;
+	YABMP_SIMPLE_CHECK(local_check_row_index(reader));
+	
+	if (index_len != ((size_t)reader->info2.height * YABMP_ROW_INDEX_VALUES_PER_ROW)) {
+		yabmp_send_error(reader, "Row index doesn't match image height.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	l_previous_offset = reader->data_offset;
+	for (i = 0U; i < reader->info2.height; ++i) {
+		const yabmp_uint32* l_entry = index + (size_t)i * YABMP_ROW_INDEX_VALUES_PER_ROW;
+		
+		/* offsets can't go backward, horizontal skip can't go past the row */
+		if ((l_entry[0] < l_previous_offset) || (l_entry[1] > reader->info2.width)) {
+			yabmp_send_error(reader, "Invalid row index entry for row %" YABMP_PRIu32 ".", i);
+			return YABMP_ERR_INVALID_ARGS;
 		}
+		l_previous_offset = l_entry[0];
 	}
 	
-	if (reader->transforms & YABMP_TRANSFORM_SCAN_ORDER) {
-		if (reader->stream_offset >= 2U * reader->input_step_bytes) {
-			/* not last line to read */
-			YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, reader->stream_offset - 2U * reader->input_step_bytes));
-		}
+	l_index = (yabmp_uint32*)yabmp_malloc(reader, index_len * sizeof(yabmp_uint32));
+	if (l_index == NULL) {
+		return YABMP_ERR_ALLOCATION;
 	}
-	reader->status |= YABMP_STATUS_HAS_LINES;
+	memcpy(l_index, index, index_len * sizeof(yabmp_uint32));
+	yabmp_free(reader, reader->row_index);
+	reader->row_index = l_index;
 	
 	return YABMP_OK;
 }
 
-YABMP_API(yabmp_status, yabmp_set_invert_scan_direction, (yabmp* instance))
+YABMP_API(yabmp_status, yabmp_read_row_ref, (yabmp* reader, const void** row))
 {
-	YABMP_CHECK_INSTANCE(instance);
+	const yabmp_uint8* l_row = NULL;
 	
-	if (instance->seek_fn == NULL) {
-		yabmp_send_error(instance, "Scan direction change is only supported with a non NULL seek function.");
-		return YABMP_ERR_UNKNOW;
+	YABMP_CHECK_READER(reader);
+	
+	if (row == NULL) {
+		yabmp_send_error(reader, "NULL row.");
+		return YABMP_ERR_INVALID_ARGS;
 	}
+	*row = NULL;
 	
-	switch (instance->info2.compression)
-	{
-		case YABMP_COMPRESSION_NONE:
-			instance->transforms |= YABMP_TRANSFORM_SCAN_ORDER;
-			break;
-  default:
-			yabmp_send_error(instance, "Scan direction change is only supported for YABMP_COMPRESSION_NONE & YABMP_COMPRESSION_BITFIELDS.");
-			return YABMP_ERR_UNKNOW;
+	YABMP_SIMPLE_CHECK(local_prepare_read(reader, 1));
+	
+	if (reader->input_data == NULL) {
+		yabmp_send_error(reader, "yabmp_read_row_ref requires a memory input.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((reader->transform_fn != NULL) || (reader->info2.compression != YABMP_COMPRESSION_NONE)) {
+		yabmp_send_error(reader, "yabmp_read_row_ref can't be used with transforms or compressed images.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if (reader->region_shift != 0U) {
+		yabmp_send_error(reader, "yabmp_read_row_ref can't be used with a region not starting on a byte boundary.");
+		return YABMP_ERR_UNKNOW;
+	}
+#if defined(YABMP_BIG_ENDIAN)
+	if ((reader->info2.flags >> YABMP_COLOR_SHIFT) & YABMP_COLOR_MASK_BITFIELDS) {
+		yabmp_send_error(reader, "yabmp_read_row_ref can't be used with bitfields images on big endian platforms.");
+		return YABMP_ERR_UNKNOW;
+	}
+#endif
+	if (((size_t)reader->stream_offset > reader->input_data_size) || ((reader->input_data_size - (size_t)reader->stream_offset) < ((size_t)reader->region_offset_bytes + (size_t)reader->region_row_bytes))) {
+		yabmp_send_error(reader, "Failed to read %zu bytes.", (size_t)reader->region_row_bytes);
+		return YABMP_ERR_UNKNOW;
 	}
+	l_row = reader->input_data + reader->stream_offset + reader->region_offset_bytes;
+	YABMP_SIMPLE_CHECK(yabmp_stream_skip(reader, reader->input_step_bytes));
+	YABMP_SIMPLE_CHECK(local_next_row(reader));
+	*row = l_row;
+	
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_invert_scan_direction, (yabmp* instance))
+{
+	YABMP_CHECK_INSTANCE(instance);
+	
+	/* requirements for row reading are checked when reading starts, yabmp_read_image has none */
+	instance->transforms |= YABMP_TRANSFORM_SCAN_ORDER;
+	
 	return YABMP_OK;
 }
 
@@ -1276,6 +3018,19 @@ YABMP_API(yabmp_status, yabmp_set_expand_to_bgrx, (yabmp* instance))
 	return YABMP_OK;
 }
 
+YABMP_API(yabmp_status, yabmp_set_expand_to_bgra, (yabmp* instance))
+{
+	YABMP_CHECK_INSTANCE(instance);
+	
+	if (instance->info2.expanded_bps > 16U) {
+		yabmp_send_error(instance, "yabmp_set_expand_to_bgra is not valid for channel depth > 16.");
+		return YABMP_ERR_UNKNOW;
+	}
+	instance->transforms |= YABMP_TRANSFORM_EXPAND | YABMP_TRANSFORM_FILL_ALPHA;
+	
+	return YABMP_OK;
+}
+
 YABMP_API(yabmp_status, yabmp_set_expand_to_grayscale, (yabmp* instance))
 {
 	YABMP_CHECK_INSTANCE(instance);
@@ -1289,3 +3044,97 @@ YABMP_API(yabmp_status, yabmp_set_expand_to_grayscale, (yabmp* instance))
 
 	return YABMP_OK;
 }
+
+YABMP_API(yabmp_status, yabmp_set_rgb_to_gray, (yabmp* instance, unsigned int weights))
+{
+	/* blue, green & red weights, 15 bits fixed point */
+	static const yabmp_uint32 l_weights[2][3] = {
+		{ 3735U, 19235U,  9798U }, /* YABMP_LUMA_BT601 */
+		{ 2366U, 23436U,  6966U }  /* YABMP_LUMA_BT709 */
+	};
+	unsigned int c;
+	
+	YABMP_CHECK_INSTANCE(instance);
+	
+	if (weights > YABMP_LUMA_BT709) {
+		yabmp_send_error(instance, "Invalid luma weights.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	for (c = 0U; c < 3U; ++c) {
+		instance->luma_weights[c] = l_weights[weights][c];
+	}
+	instance->transforms |= YABMP_TRANSFORM_GRAYSCALE;
+	
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_scale_to_full_range, (yabmp* instance))
+{
+	YABMP_CHECK_INSTANCE(instance);
+	
+	instance->transforms |= YABMP_TRANSFORM_SCALE;
+	
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_output_format, (yabmp* instance, unsigned int format))
+{
+	YABMP_CHECK_INSTANCE(instance);
+	
+	if ((format & ~(YABMP_OUTPUT_RGB | YABMP_OUTPUT_ALPHA_FIRST | YABMP_OUTPUT_BIG_ENDIAN)) != 0U) {
+		yabmp_send_error(instance, "Invalid output format.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	instance->output_format = format;
+	
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_row_alignment, (yabmp* reader, unsigned int alignment))
+{
+	YABMP_CHECK_READER(reader);
+	
+	if ((alignment == 0U) || (alignment > 256U) || ((alignment & (alignment - 1U)) != 0U)) {
+		yabmp_send_error(reader, "Invalid row alignment %u.", alignment);
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	reader->row_alignment = alignment;
+	
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_read_region, (yabmp* reader, yabmp_uint32 x, yabmp_uint32 y, yabmp_uint32 width, yabmp_uint32 height))
+{
+	YABMP_CHECK_READER(reader);
+	
+	if ((reader->status & YABMP_STATUS_HAS_INFO) == 0U) {
+		yabmp_send_error(reader, "yabmp_read_info not called.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((reader->status & YABMP_STATUS_HAS_LINES) != 0U) {
+		yabmp_send_error(reader, "Region can't be changed once rows have been read.");
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((width == 0U) || (height == 0U) || (x >= reader->info2.width) || (width > (reader->info2.width - x)) || (y >= reader->info2.height) || (height > (reader->info2.height - y))) {
+		yabmp_send_error(reader, "Invalid region.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	reader->region_x = x;
+	reader->region_y = y;
+	reader->region_width  = width;
+	reader->region_height = height;
+	
+	return YABMP_OK;
+}
+
+YABMP_API(yabmp_status, yabmp_set_decode_threads, (yabmp* reader, unsigned int thread_count, void* parallel_context, yabmp_parallel_for_cb parallel_fn))
+{
+	YABMP_CHECK_READER(reader);
+	
+	reader->task_count = thread_count;
+	reader->parallel_context = parallel_context;
+	reader->parallel_fn = parallel_fn;
+	
+	return YABMP_OK;
+}
@@ -34,7 +34,7 @@ YABMP_IAPI(void, yabmp_swap16u, (const yabmp* instance, yabmp_uint16* pSrcDst))
 	assert(instance != NULL);
 	assert(pSrcDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
+	l_width      = (yabmp_uint32)instance->region_width;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
@@ -48,7 +48,7 @@ YABMP_IAPI(void, yabmp_swap32u, (const yabmp* instance, yabmp_uint32* pSrcDst))
 	assert(instance != NULL);
 	assert(pSrcDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
+	l_width      = (yabmp_uint32)instance->region_width;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
@@ -82,11 +82,35 @@ YABMP_IAPI(void, yabmp_bitfield_get_shift_and_bits, (yabmp_uint32 mask, unsigned
 	*bits = l_bits;
 }
 
-YABMP_IAPI(void, yabmp_bf32u_to_bgr24, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+static yabmp_uint32 local_swap16(yabmp_uint32 value)
+{
+	return ((value >> 8) & 0xFFU) | ((value & 0xFFU) << 8);
+}
+
+/* stores value as 4 bytes, least significant byte first */
+static void local_store_le32(yabmp_uint8* pDst, yabmp_uint32 value)
+{
+#if defined(YABMP_BIG_ENDIAN)
+	pDst[0] = (yabmp_uint8)value;
+	pDst[1] = (yabmp_uint8)(value >> 8);
+	pDst[2] = (yabmp_uint8)(value >> 16);
+	pDst[3] = (yabmp_uint8)(value >> 24);
+#else
+	memcpy(pDst, &value, sizeof(value));
+#endif
+}
+
+/* src_bytes, channels & dst_bytes are constants in callers, each of those gets its own specialized loop */
+/* channels are written in output order, masks & shifts are reordered by local_setup_read */
+/* filled alpha is either the first or the last channel */
+static void local_bf_expand(const yabmp* instance, const void* pSrc, void* pDst, unsigned int src_bytes, unsigned int channels, unsigned int dst_bytes)
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift;
-	yabmp_uint32 l_blue_mask, l_green_mask, l_red_mask;
+	yabmp_uint32 l_mask0, l_mask1, l_mask2, l_mask3;
+	unsigned int l_shift0, l_shift1, l_shift2, l_shift3;
+	yabmp_uint32 l_fill0, l_fill3;
+	int l_swap;
+	yabmp_uint8*  l_dst8  = (yabmp_uint8*)pDst;
+	yabmp_uint16* l_dst16 = (yabmp_uint16*)pDst;
 	
 	yabmp_uint32 x, l_width;
 	
@@ -94,652 +118,766 @@ YABMP_IAPI(void, yabmp_bf32u_to_bgr24, (const yabmp* instance, const yabmp_uint3
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = instance->info2.mask_blue;
-	l_green_mask = instance->info2.mask_green;
-	l_red_mask   = instance->info2.mask_red;
-	
-	yabmp_bitfield_get_shift_and_bits(l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_red_mask, &l_red_shift, &l_dummy_bits);
+	l_width  = (yabmp_uint32)instance->region_width;
+	l_mask0  = instance->out_mask[0];
+	l_mask1  = instance->out_mask[1];
+	l_mask2  = instance->out_mask[2];
+	l_mask3  = instance->out_mask[3];
+	l_shift0 = instance->out_shift[0];
+	l_shift1 = instance->out_shift[1];
+	l_shift2 = instance->out_shift[2];
+	l_shift3 = instance->out_shift[3];
+	l_fill0  = instance->out_fill[0];
+	l_fill3  = instance->out_fill[3];
+	l_swap   = instance->out_swap16;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint32 l_value = pSrc[x];
-		
-		pDst[3*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[3*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[3*x+2] = (l_value & l_red_mask)   >> l_red_shift;
+		yabmp_uint32 l_value = (src_bytes == 2U) ? ((const yabmp_uint16*)pSrc)[x] : ((const yabmp_uint32*)pSrc)[x];
+		yabmp_uint32 l_value0 = ((l_value & l_mask0) >> l_shift0) | l_fill0;
+		yabmp_uint32 l_value1 = (l_value & l_mask1) >> l_shift1;
+		yabmp_uint32 l_value2 = (l_value & l_mask2) >> l_shift2;
+		yabmp_uint32 l_value3 = ((l_value & l_mask3) >> l_shift3) | l_fill3;
+		
+		if (dst_bytes == 1U) {
+			l_dst8[0] = (yabmp_uint8)l_value0;
+			l_dst8[1] = (yabmp_uint8)l_value1;
+			l_dst8[2] = (yabmp_uint8)l_value2;
+			if (channels == 4U) {
+				l_dst8[3] = (yabmp_uint8)l_value3;
+			}
+			l_dst8 += channels;
+		} else {
+			if (l_swap) {
+				l_value0 = local_swap16(l_value0);
+				l_value1 = local_swap16(l_value1);
+				l_value2 = local_swap16(l_value2);
+				l_value3 = local_swap16(l_value3);
+			}
+			l_dst16[0] = (yabmp_uint16)l_value0;
+			l_dst16[1] = (yabmp_uint16)l_value1;
+			l_dst16[2] = (yabmp_uint16)l_value2;
+			if (channels == 4U) {
+				l_dst16[3] = (yabmp_uint16)l_value3;
+			}
+			l_dst16 += channels;
+		}
 	}
 }
 
+YABMP_IAPI(void, yabmp_bf32u_to_bgr24, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 4U, 3U, 1U);
+}
+
 YABMP_IAPI(void, yabmp_bf32u_to_bgr48, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift;
-	yabmp_uint32 l_blue_mask, l_green_mask, l_red_mask;
-	
+	local_bf_expand(instance, pSrc, pDst, 4U, 3U, 2U);
+}
+
+YABMP_IAPI(void, yabmp_bf32u_to_bgra32, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 4U, 4U, 1U);
+}
+
+YABMP_IAPI(void, yabmp_bf32u_to_bgra64, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 4U, 4U, 2U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_to_bgr24, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 2U, 3U, 1U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_to_bgr48, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 2U, 3U, 2U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_to_bgra32, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 2U, 4U, 1U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_to_bgra64, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_expand(instance, pSrc, pDst, 2U, 4U, 2U);
+}
+
+/* Specialized kernels for common masks, constant shifts let the compiler vectorize those loops */
+/* 5 bits blue & red, green_bits bits green, red may come first, optionally scaled to full range */
+/* opaque alpha is added last with 4 channels */
+static void local_bf16u_to_bgr(const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst, unsigned int green_bits, int scale, unsigned int channels)
+{
 	yabmp_uint32 x, l_width;
+	unsigned int l_shift0, l_shift2;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = instance->info2.mask_blue;
-	l_green_mask = instance->info2.mask_green;
-	l_red_mask   = instance->info2.mask_red;
-	
-	yabmp_bitfield_get_shift_and_bits(l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_red_mask, &l_red_shift, &l_dummy_bits);
+	l_width  = (yabmp_uint32)instance->region_width;
+	l_shift0 = instance->out_shift[0];
+	l_shift2 = instance->out_shift[2];
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint32 l_value = pSrc[x];
-		
-		pDst[3*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[3*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[3*x+2] = (l_value & l_red_mask)   >> l_red_shift;
+		yabmp_uint32 l_value0 = (pSrc[x] >> l_shift0) & 0x1FU;
+		yabmp_uint32 l_green  = (pSrc[x] >> 5) & ((1U << green_bits) - 1U);
+		yabmp_uint32 l_value2 = (pSrc[x] >> l_shift2) & 0x1FU;
+		
+		if (scale) {
+			/* same as yabmp_bitfield_replicate */
+			l_value0 = (l_value0 << 3) | (l_value0 >> 2);
+			l_green  = (l_green << (8U - green_bits)) | (l_green >> (2U * green_bits - 8U));
+			l_value2 = (l_value2 << 3) | (l_value2 >> 2);
+		}
+		pDst[channels*x+0] = (yabmp_uint8)l_value0;
+		pDst[channels*x+1] = (yabmp_uint8)l_green;
+		pDst[channels*x+2] = (yabmp_uint8)l_value2;
+		if (channels == 4U) {
+			pDst[channels*x+3] = 0xFFU;
+		}
 	}
 }
 
-YABMP_IAPI(void, yabmp_bf32u_to_bgra32, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 6U, 0, 3U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 5U, 0, 3U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 6U, 1, 3U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 5U, 1, 3U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 6U, 0, 4U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 5U, 0, 4U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 6U, 1, 4U);
+}
+
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr(instance, pSrc, pDst, 5U, 1, 4U);
+}
+
+YABMP_IAPI(void, yabmp_bf32u_x8r8g8b8_to_bgr24, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift, l_alpha_shift;
-	yabmp_uint32 l_blue_mask, l_green_mask, l_red_mask, l_alpha_mask;
-	
 	yabmp_uint32 x, l_width;
+	unsigned int l_shift0, l_shift2;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = instance->info2.mask_blue;
-	l_green_mask = instance->info2.mask_green;
-	l_red_mask   = instance->info2.mask_red;
-	l_alpha_mask = instance->info2.mask_alpha;
-	
-	yabmp_bitfield_get_shift_and_bits(l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_red_mask, &l_red_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_alpha_mask, &l_alpha_shift, &l_dummy_bits);
+	l_width  = (yabmp_uint32)instance->region_width;
+	l_shift0 = instance->out_shift[0];
+	l_shift2 = instance->out_shift[2];
 	
 	for(x = 0U; x < l_width; ++x)
 	{
 		yabmp_uint32 l_value = pSrc[x];
 		
-		pDst[4*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[4*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[4*x+2] = (l_value & l_red_mask)   >> l_red_shift;
-		pDst[4*x+3] = (l_value & l_alpha_mask) >> l_alpha_shift;
+		pDst[3*x+0] = (yabmp_uint8)(l_value >> l_shift0);
+		pDst[3*x+1] = (yabmp_uint8)(l_value >> 8);
+		pDst[3*x+2] = (yabmp_uint8)(l_value >> l_shift2);
 	}
 }
 
-YABMP_IAPI(void, yabmp_bf32u_to_bgra64, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
+YABMP_IAPI(void, yabmp_bf32u_a8r8g8b8_to_bgra32, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift, l_alpha_shift;
-	yabmp_uint32 l_blue_mask, l_green_mask, l_red_mask, l_alpha_mask;
-	
-	yabmp_uint32 x, l_width;
+	yabmp_uint32 l_width;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = instance->info2.mask_blue;
-	l_green_mask = instance->info2.mask_green;
-	l_red_mask   = instance->info2.mask_red;
-	l_alpha_mask = instance->info2.mask_alpha;
-	
-	yabmp_bitfield_get_shift_and_bits(l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_red_mask, &l_red_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits(l_alpha_mask, &l_alpha_shift, &l_dummy_bits);
+	l_width = (yabmp_uint32)instance->region_width;
 	
-	for(x = 0U; x < l_width; ++x)
+#if defined(YABMP_BIG_ENDIAN)
 	{
-		yabmp_uint32 l_value = pSrc[x];
-		
-		pDst[4*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[4*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[4*x+2] = (l_value & l_red_mask)   >> l_red_shift;
-		pDst[4*x+3] = (l_value & l_alpha_mask) >> l_alpha_shift;
+		yabmp_uint32 x;
+		
+		for(x = 0U; x < l_width; ++x)
+		{
+			yabmp_uint32 l_value = pSrc[x];
+			
+			pDst[4*x+0] = (yabmp_uint8)l_value;
+			pDst[4*x+1] = (yabmp_uint8)(l_value >> 8);
+			pDst[4*x+2] = (yabmp_uint8)(l_value >> 16);
+			pDst[4*x+3] = (yabmp_uint8)(l_value >> 24);
+		}
 	}
+#else
+	/* already in BGRA order in memory */
+	memcpy(pDst, pSrc, (size_t)l_width * 4U);
+#endif
 }
 
-YABMP_IAPI(void, yabmp_bf16u_to_bgr24, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+YABMP_IAPI(void, yabmp_bf32u_x8r8g8b8_to_bgra32, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift;
-	yabmp_uint16 l_blue_mask, l_green_mask, l_red_mask;
-	
 	yabmp_uint32 x, l_width;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = (yabmp_uint16)instance->info2.mask_blue;
-	l_green_mask = (yabmp_uint16)instance->info2.mask_green;
-	l_red_mask   = (yabmp_uint16)instance->info2.mask_red;
-	
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_red_mask, &l_red_shift, &l_dummy_bits);
+	l_width = (yabmp_uint32)instance->region_width;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint16 l_value = pSrc[x];
-		
-		pDst[3*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[3*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[3*x+2] = (l_value & l_red_mask)   >> l_red_shift;
+		local_store_le32(pDst + 4U * x, pSrc[x] | 0xFF000000U);
 	}
 }
-YABMP_IAPI(void, yabmp_bf16u_to_bgr48, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ))
+
+YABMP_IAPI(void, yabmp_bf32u_a2r10g10b10_to_bgra64, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift;
-	yabmp_uint16 l_blue_mask, l_green_mask, l_red_mask;
-	
 	yabmp_uint32 x, l_width;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = (yabmp_uint16)instance->info2.mask_blue;
-	l_green_mask = (yabmp_uint16)instance->info2.mask_green;
-	l_red_mask   = (yabmp_uint16)instance->info2.mask_red;
-	
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_red_mask, &l_red_shift, &l_dummy_bits);
+	l_width = (yabmp_uint32)instance->region_width;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint16 l_value = pSrc[x];
+		yabmp_uint32 l_value = pSrc[x];
 		
-		pDst[3*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[3*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[3*x+2] = (l_value & l_red_mask)   >> l_red_shift;
+		pDst[4*x+0] = (yabmp_uint16)(l_value & 0x3FFU);
+		pDst[4*x+1] = (yabmp_uint16)((l_value >> 10) & 0x3FFU);
+		pDst[4*x+2] = (yabmp_uint16)((l_value >> 20) & 0x3FFU);
+		pDst[4*x+3] = (yabmp_uint16)(l_value >> 30);
 	}
 }
-YABMP_IAPI(void, yabmp_bf16u_to_bgra32, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+
+YABMP_IAPI(void, yabmp_bf32u_a2r10g10b10_to_bgra64_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift, l_alpha_shift;
-	yabmp_uint16 l_blue_mask, l_green_mask, l_red_mask, l_alpha_mask;
-	
 	yabmp_uint32 x, l_width;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = (yabmp_uint16)instance->info2.mask_blue;
-	l_green_mask = (yabmp_uint16)instance->info2.mask_green;
-	l_red_mask   = (yabmp_uint16)instance->info2.mask_red;
-	l_alpha_mask = (yabmp_uint16)instance->info2.mask_alpha;
-	
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_red_mask, &l_red_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_alpha_mask, &l_alpha_shift, &l_dummy_bits);
+	l_width = (yabmp_uint32)instance->region_width;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint16 l_value = pSrc[x];
-		
-		pDst[4*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[4*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[4*x+2] = (l_value & l_red_mask)   >> l_red_shift;
-		pDst[4*x+3] = (l_value & l_alpha_mask) >> l_alpha_shift;
+		yabmp_uint32 l_value = pSrc[x];
+		yabmp_uint32 l_blue  = l_value & 0x3FFU;
+		yabmp_uint32 l_green = (l_value >> 10) & 0x3FFU;
+		yabmp_uint32 l_red   = (l_value >> 20) & 0x3FFU;
+		
+		/* same as yabmp_bitfield_replicate */
+		pDst[4*x+0] = (yabmp_uint16)((l_blue << 6) | (l_blue >> 4));
+		pDst[4*x+1] = (yabmp_uint16)((l_green << 6) | (l_green >> 4));
+		pDst[4*x+2] = (yabmp_uint16)((l_red << 6) | (l_red >> 4));
+		pDst[4*x+3] = (yabmp_uint16)((l_value >> 30) * 0x5555U);
 	}
 }
 
-YABMP_IAPI(void, yabmp_bf16u_to_bgra64, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ))
+YABMP_IAPI(yabmp_uint32, yabmp_bitfield_replicate, (yabmp_uint32 value, unsigned int bits, unsigned int target_bits))
 {
-	unsigned int l_dummy_bits;
-	unsigned int l_blue_shift, l_green_shift, l_red_shift, l_alpha_shift;
-	yabmp_uint16 l_blue_mask, l_green_mask, l_red_mask, l_alpha_mask;
+	yabmp_uint32 l_result = 0U;
+	int j;
+	
+	assert(bits <= target_bits);
 	
+	if (bits == 0U) {
+		return 0U;
+	}
+	/* same bit replication as libpng png_set_shift */
+	for (j = (int)target_bits - (int)bits; j > -(int)bits; j -= (int)bits) {
+		if (j > 0) {
+			l_result |= value << j;
+		} else {
+			l_result |= value >> -j;
+		}
+	}
+	return l_result;
+}
+
+/* same as local_bf_expand, samples go through full range tables, byte swapped when needed by local_setup_read */
+static void local_bf_to_scaled(const yabmp* instance, const void* pSrc, void* pDst, unsigned int src_bytes, unsigned int channels, unsigned int dst_bytes)
+{
 	yabmp_uint32 x, l_width;
+	yabmp_uint32 l_mask0, l_mask1, l_mask2, l_mask3;
+	unsigned int l_shift0, l_shift1, l_shift2, l_shift3;
+	const yabmp_uint8  *l_lut8_0, *l_lut8_1, *l_lut8_2, *l_lut8_3;
+	const yabmp_uint16 *l_lut16_0, *l_lut16_1, *l_lut16_2, *l_lut16_3;
+	yabmp_uint8*  l_dst8  = (yabmp_uint8*)pDst;
+	yabmp_uint16* l_dst16 = (yabmp_uint16*)pDst;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_width      = (yabmp_uint32)instance->info2.width;
-	l_blue_mask  = (yabmp_uint16)instance->info2.mask_blue;
-	l_green_mask = (yabmp_uint16)instance->info2.mask_green;
-	l_red_mask   = (yabmp_uint16)instance->info2.mask_red;
-	l_alpha_mask = (yabmp_uint16)instance->info2.mask_alpha;
-	
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_blue_mask, &l_blue_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_green_mask, &l_green_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_red_mask, &l_red_shift, &l_dummy_bits);
-	yabmp_bitfield_get_shift_and_bits((yabmp_uint32)l_alpha_mask, &l_alpha_shift, &l_dummy_bits);
+	/* locals, stores to pDst could otherwise alias instance */
+	l_width   = (yabmp_uint32)instance->region_width;
+	l_mask0   = instance->out_mask[0];
+	l_mask1   = instance->out_mask[1];
+	l_mask2   = instance->out_mask[2];
+	l_mask3   = instance->out_mask[3];
+	l_shift0  = instance->out_shift[0];
+	l_shift1  = instance->out_shift[1];
+	l_shift2  = instance->out_shift[2];
+	l_shift3  = instance->out_shift[3];
+	l_lut8_0  = (const yabmp_uint8*)instance->scale_lut[0];
+	l_lut8_1  = (const yabmp_uint8*)instance->scale_lut[1];
+	l_lut8_2  = (const yabmp_uint8*)instance->scale_lut[2];
+	l_lut8_3  = (const yabmp_uint8*)instance->scale_lut[3];
+	l_lut16_0 = (const yabmp_uint16*)instance->scale_lut[0];
+	l_lut16_1 = (const yabmp_uint16*)instance->scale_lut[1];
+	l_lut16_2 = (const yabmp_uint16*)instance->scale_lut[2];
+	l_lut16_3 = (const yabmp_uint16*)instance->scale_lut[3];
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint16 l_value = pSrc[x];
-		
-		pDst[4*x+0] = (l_value & l_blue_mask)  >> l_blue_shift;
-		pDst[4*x+1] = (l_value & l_green_mask) >> l_green_shift;
-		pDst[4*x+2] = (l_value & l_red_mask)   >> l_red_shift;
-		pDst[4*x+3] = (l_value & l_alpha_mask) >> l_alpha_shift;
+		yabmp_uint32 l_value = (src_bytes == 2U) ? ((const yabmp_uint16*)pSrc)[x] : ((const yabmp_uint32*)pSrc)[x];
+		yabmp_uint32 l_value0 = (l_value & l_mask0) >> l_shift0;
+		yabmp_uint32 l_value1 = (l_value & l_mask1) >> l_shift1;
+		yabmp_uint32 l_value2 = (l_value & l_mask2) >> l_shift2;
+		
+		if (dst_bytes == 1U) {
+			l_dst8[0] = l_lut8_0[l_value0];
+			l_dst8[1] = l_lut8_1[l_value1];
+			l_dst8[2] = l_lut8_2[l_value2];
+			if (channels == 4U) {
+				l_dst8[3] = l_lut8_3[(l_value & l_mask3) >> l_shift3];
+			}
+			l_dst8 += channels;
+		} else {
+			l_dst16[0] = l_lut16_0[l_value0];
+			l_dst16[1] = l_lut16_1[l_value1];
+			l_dst16[2] = l_lut16_2[l_value2];
+			if (channels == 4U) {
+				l_dst16[3] = l_lut16_3[(l_value & l_mask3) >> l_shift3];
+			}
+			l_dst16 += channels;
+		}
 	}
 }
 
-YABMP_IAPI(void, yabmp_pal1_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+YABMP_IAPI(void, yabmp_bf16u_to_bgr24_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
 {
-	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
+	local_bf_to_scaled(instance, pSrc, pDst, 2U, 3U, 1U);
+}
+YABMP_IAPI(void, yabmp_bf16u_to_bgr48_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 2U, 3U, 2U);
+}
+YABMP_IAPI(void, yabmp_bf16u_to_bgra32_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 2U, 4U, 1U);
+}
+YABMP_IAPI(void, yabmp_bf16u_to_bgra64_scaled, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 2U, 4U, 2U);
+}
+YABMP_IAPI(void, yabmp_bf32u_to_bgr24_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 4U, 3U, 1U);
+}
+YABMP_IAPI(void, yabmp_bf32u_to_bgr48_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 4U, 3U, 2U);
+}
+YABMP_IAPI(void, yabmp_bf32u_to_bgra32_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 4U, 4U, 1U);
+}
+YABMP_IAPI(void, yabmp_bf32u_to_bgra64_scaled, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint16* pDst ))
+{
+	local_bf_to_scaled(instance, pSrc, pDst, 4U, 4U, 2U);
+}
+
+/* color packed as first | second << 8 | third << 16 in output channel order, opaque alpha added with YABMP_TRANSFORM_FILL_ALPHA */
+static yabmp_uint32 local_pack_color(const yabmp* instance, const yabmp_color* color)
+{
+	yabmp_uint32 l_color;
 	
-	assert(instance != NULL);
-	assert(pSrc != NULL);
-	assert(pDst != NULL);
+	if (instance->output_format & YABMP_OUTPUT_RGB) {
+		l_color = (yabmp_uint32)color->red | ((yabmp_uint32)color->green << 8) | ((yabmp_uint32)color->blue << 16);
+	} else {
+		l_color = (yabmp_uint32)color->blue | ((yabmp_uint32)color->green << 8) | ((yabmp_uint32)color->red << 16);
+	}
+	if (instance->transforms & YABMP_TRANSFORM_FILL_ALPHA) {
+		if (instance->output_format & YABMP_OUTPUT_ALPHA_FIRST) {
+			l_color = (l_color << 8) | 0xFFU;
+		} else {
+			l_color |= 0xFF000000U;
+		}
+	}
+	return l_color;
+}
+
+YABMP_IAPI(void, yabmp_prepare_palette_packed, (yabmp* instance))
+{
+	unsigned int i;
 	
-	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
+	assert(instance != NULL);
 	
-	for(x = 0U; x < l_width / 8U; ++x)
-	{
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		
-		l_current = (l_value >> 7) & 0x01;
-		pDst[24*x+0] = l_palette[l_current].blue;
-		pDst[24*x+1] = l_palette[l_current].green;
-		pDst[24*x+2] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 6) & 0x01;
-		pDst[24*x+3] = l_palette[l_current].blue;
-		pDst[24*x+4] = l_palette[l_current].green;
-		pDst[24*x+5] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 5) & 0x01;
-		pDst[24*x+6] = l_palette[l_current].blue;
-		pDst[24*x+7] = l_palette[l_current].green;
-		pDst[24*x+8] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 4) & 0x01;
-		pDst[24*x+9] = l_palette[l_current].blue;
-		pDst[24*x+10] = l_palette[l_current].green;
-		pDst[24*x+11] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 3) & 0x01;
-		pDst[24*x+12] = l_palette[l_current].blue;
-		pDst[24*x+13] = l_palette[l_current].green;
-		pDst[24*x+14] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 2) & 0x01;
-		pDst[24*x+15] = l_palette[l_current].blue;
-		pDst[24*x+16] = l_palette[l_current].green;
-		pDst[24*x+17] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 1) & 0x01;
-		pDst[24*x+18] = l_palette[l_current].blue;
-		pDst[24*x+19] = l_palette[l_current].green;
-		pDst[24*x+20] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 0) & 0x01;
-		pDst[24*x+21] = l_palette[l_current].blue;
-		pDst[24*x+22] = l_palette[l_current].green;
-		pDst[24*x+23] = l_palette[l_current].red;
+	for (i = 0U; i < 256U; ++i) {
+		instance->palette_packed[i] = local_pack_color(instance, instance->info2.palette + i);
 	}
+}
+
+YABMP_IAPI(void, yabmp_prepare_palette_gray, (yabmp* instance))
+{
+	const yabmp_uint32* l_weights;
+	unsigned int i;
 	
-	if (l_width & 7U) {
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		int l_remaining = (int)l_width & 7U;
-		
-		l_current = (l_value >> 7) & 0x01;
-		pDst[24*x+0] = l_palette[l_current].blue;
-		pDst[24*x+1] = l_palette[l_current].green;
-		pDst[24*x+2] = l_palette[l_current].red;
+	assert(instance != NULL);
+	
+	l_weights = instance->luma_weights;
+	for (i = 0U; i < 256U; ++i) {
+		const yabmp_color* l_color = instance->info2.palette + i;
 		
-		if (l_remaining > 1) {
-			l_current = (l_value >> 6) & 0x01;
-			pDst[24*x+3] = l_palette[l_current].blue;
-			pDst[24*x+4] = l_palette[l_current].green;
-			pDst[24*x+5] = l_palette[l_current].red;
-		}
-		if (l_remaining > 2) {
-			l_current = (l_value >> 5) & 0x01;
-			pDst[24*x+6] = l_palette[l_current].blue;
-			pDst[24*x+7] = l_palette[l_current].green;
-			pDst[24*x+8] = l_palette[l_current].red;
-		}
-		if (l_remaining > 3) {
-			l_current = (l_value >> 4) & 0x01;
-			pDst[24*x+9] = l_palette[l_current].blue;
-			pDst[24*x+10] = l_palette[l_current].green;
-			pDst[24*x+11] = l_palette[l_current].red;
-		}
-		if (l_remaining > 4) {
-			l_current = (l_value >> 3) & 0x01;
-			pDst[24*x+12] = l_palette[l_current].blue;
-			pDst[24*x+13] = l_palette[l_current].green;
-			pDst[24*x+14] = l_palette[l_current].red;
-		}
-		if (l_remaining > 5) {
-			l_current = (l_value >> 2) & 0x01;
-			pDst[24*x+15] = l_palette[l_current].blue;
-			pDst[24*x+16] = l_palette[l_current].green;
-			pDst[24*x+17] = l_palette[l_current].red;
-		}
-		if (l_remaining > 6) {
-			l_current = (l_value >> 1) & 0x01;
-			pDst[24*x+18] = l_palette[l_current].blue;
-			pDst[24*x+19] = l_palette[l_current].green;
-			pDst[24*x+20] = l_palette[l_current].red;
+		if ((l_weights[0] | l_weights[1] | l_weights[2]) == 0U) {
+			/* gray palette */
+			instance->palette_gray[i] = l_color->blue;
+		} else {
+			instance->palette_gray[i] = (yabmp_uint8)((l_weights[0] * l_color->blue + l_weights[1] * l_color->green + l_weights[2] * l_color->red + 16384U) >> 15);
 		}
 	}
 }
 
-YABMP_IAPI(void, yabmp_pal2_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+YABMP_IAPI(void, yabmp_prepare_expand_lut, (yabmp* instance, unsigned int bpp, unsigned int bytes_per_pixel))
 {
-	yabmp_uint32 x, l_width;
+	unsigned int l_value, l_pixels_per_byte;
+	yabmp_uint8* l_dst;
 	const yabmp_color *l_palette;
 	
 	assert(instance != NULL);
-	assert(pSrc != NULL);
-	assert(pDst != NULL);
+	assert(instance->expand_lut != NULL);
+	assert((bpp == 1U) || (bpp == 2U) || (bpp == 4U));
+	assert((bytes_per_pixel == 1U) || (bytes_per_pixel == 3U) || (bytes_per_pixel == 4U));
+	assert(instance->expand_lut_size >= (256U * (8U / bpp) * bytes_per_pixel));
 	
 	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
-	
-	for(x = 0U; x < l_width / 4U; ++x)
-	{
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		
-		l_current = (l_value >> 6) & 0x03;
-		pDst[12*x+0] = l_palette[l_current].blue;
-		pDst[12*x+1] = l_palette[l_current].green;
-		pDst[12*x+2] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 4) & 0x03;
-		pDst[12*x+3] = l_palette[l_current].blue;
-		pDst[12*x+4] = l_palette[l_current].green;
-		pDst[12*x+5] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 2) & 0x03;
-		pDst[12*x+6] = l_palette[l_current].blue;
-		pDst[12*x+7] = l_palette[l_current].green;
-		pDst[12*x+8] = l_palette[l_current].red;
-		
-		l_current = (l_value >> 0) & 0x03;
-		pDst[12*x+9] = l_palette[l_current].blue;
-		pDst[12*x+10] = l_palette[l_current].green;
-		pDst[12*x+11] = l_palette[l_current].red;
+	l_pixels_per_byte = 8U / bpp;
+	l_dst = instance->expand_lut;
+	
+	/* entry l_value holds the l_pixels_per_byte pixels packed in byte l_value, most significant bits first */
+	for (l_value = 0U; l_value < 256U; ++l_value) {
+		unsigned int i;
+		
+		for (i = 0U; i < l_pixels_per_byte; ++i) {
+			unsigned int l_current = (l_value >> (8U - bpp * (i + 1U))) & ((1U << bpp) - 1U);
+			
+			if (bytes_per_pixel == 4U) {
+				local_store_le32(l_dst, local_pack_color(instance, l_palette + l_current));
+				l_dst += 4;
+			} else if (bytes_per_pixel == 3U) {
+				yabmp_uint32 l_color = local_pack_color(instance, l_palette + l_current);
+				
+				*l_dst++ = (yabmp_uint8)l_color;
+				*l_dst++ = (yabmp_uint8)(l_color >> 8);
+				*l_dst++ = (yabmp_uint8)(l_color >> 16);
+			} else {
+				*l_dst++ = instance->palette_gray[l_current];
+			}
+		}
 	}
+}
+
+YABMP_IAPI(void, yabmp_prepare_rle_lut, (yabmp* instance, unsigned int bytes_per_pixel))
+{
+	unsigned int l_value;
+	yabmp_uint8* l_dst;
 	
-	if (l_width & 3U) {
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		int l_remaining = (int)l_width & 3U;
-		
-		l_current = (l_value >> 6) & 0x03;
-		pDst[12*x+0] = l_palette[l_current].blue;
-		pDst[12*x+1] = l_palette[l_current].green;
-		pDst[12*x+2] = l_palette[l_current].red;
-		
-		if (l_remaining > 1) {
-			l_current = (l_value >> 4) & 0x03;
-			pDst[12*x+3] = l_palette[l_current].blue;
-			pDst[12*x+4] = l_palette[l_current].green;
-			pDst[12*x+5] = l_palette[l_current].red;
+	assert(instance != NULL);
+	assert(instance->expand_lut != NULL);
+	assert((bytes_per_pixel == 1U) || (bytes_per_pixel == 3U) || (bytes_per_pixel == 4U));
+	assert(instance->expand_lut_size >= (256U * 16U));
+	
+	l_dst = instance->expand_lut;
+	
+	/* entry l_value holds 16 bytes of pixels alternating the 2 indices of an RLE4 run byte l_value, RLE8 runs use both times the same index */
+	for (l_value = 0U; l_value < 256U; ++l_value) {
+		unsigned int l_indices[2];
+		unsigned int i;
+		
+		if (instance->info2.compression == YABMP_COMPRESSION_RLE4) {
+			l_indices[0] = l_value >> 4;
+			l_indices[1] = l_value & 0xFU;
+		} else {
+			l_indices[0] = l_value;
+			l_indices[1] = l_value;
 		}
-		if (l_remaining > 2) {
-			l_current = (l_value >> 2) & 0x03;
-			pDst[12*x+6] = l_palette[l_current].blue;
-			pDst[12*x+7] = l_palette[l_current].green;
-			pDst[12*x+8] = l_palette[l_current].red;
+		for (i = 0U; i < 16U; ++i) {
+			unsigned int l_current = l_indices[(i / bytes_per_pixel) & 1U];
+			
+			if (bytes_per_pixel == 1U) {
+				*l_dst++ = instance->palette_gray[l_current];
+			} else {
+				*l_dst++ = (yabmp_uint8)(instance->palette_packed[l_current] >> (8U * (i % bytes_per_pixel)));
+			}
 		}
 	}
 }
 
-YABMP_IAPI(void, yabmp_pal4_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+/* out_bytes output bytes per source byte, width / pixels_per_byte full source bytes */
+static void local_lut_expand(const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst, unsigned int pixels_per_byte, unsigned int out_bytes)
 {
-	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
+	yabmp_uint32 x, l_width, l_remaining;
+	const yabmp_uint8 *l_lut;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
+	assert(instance->expand_lut != NULL);
 	
-	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
+	l_lut = instance->expand_lut;
+	l_width = (yabmp_uint32)instance->region_width;
 	
-	for(x = 0U; x < l_width / 2U; ++x)
+	for(x = 0U; x < l_width / pixels_per_byte; ++x)
 	{
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_value_lo = l_value & 0x0F;
-		
-		l_value >>= 4;
-		
-		pDst[6*x+0] = l_palette[l_value].blue;
-		pDst[6*x+1] = l_palette[l_value].green;
-		pDst[6*x+2] = l_palette[l_value].red;
-		
-		pDst[6*x+3] = l_palette[l_value_lo].blue;
-		pDst[6*x+4] = l_palette[l_value_lo].green;
-		pDst[6*x+5] = l_palette[l_value_lo].red;
+		memcpy(pDst, l_lut + out_bytes * pSrc[x], out_bytes);
+		pDst += out_bytes;
 	}
 	
-	if (l_width & 1U) {
-		yabmp_uint8 l_value = pSrc[x] >> 4;
-		
-		pDst[6*x+0] = l_palette[l_value].blue;
-		pDst[6*x+1] = l_palette[l_value].green;
-		pDst[6*x+2] = l_palette[l_value].red;
+	l_remaining = l_width % pixels_per_byte;
+	if (l_remaining != 0U) {
+		memcpy(pDst, l_lut + out_bytes * pSrc[x], l_remaining * (out_bytes / pixels_per_byte));
 	}
 }
 
+YABMP_IAPI(void, yabmp_pal1_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 8U, 24U);
+}
+
+YABMP_IAPI(void, yabmp_pal2_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 4U, 12U);
+}
+
+YABMP_IAPI(void, yabmp_pal4_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 2U, 6U);
+}
+
 YABMP_IAPI(void, yabmp_pal8_to_bgr24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
 {
 	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
+	const yabmp_uint32 *l_palette;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_palette = instance->info2.palette;
-	l_width      = (yabmp_uint32)instance->info2.width;
+	l_palette = instance->palette_packed;
+	l_width      = (yabmp_uint32)instance->region_width;
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint8 l_value = pSrc[x];
+		yabmp_uint32 l_color = l_palette[pSrc[x]];
 		
-		pDst[3*x+0] = l_palette[l_value].blue;
-		pDst[3*x+1] = l_palette[l_value].green;
-		pDst[3*x+2] = l_palette[l_value].red;
+		pDst[3*x+0] = (yabmp_uint8)l_color;
+		pDst[3*x+1] = (yabmp_uint8)(l_color >> 8);
+		pDst[3*x+2] = (yabmp_uint8)(l_color >> 16);
 	}
 }
 
-YABMP_IAPI(void, yabmp_pal1_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+YABMP_IAPI(void, yabmp_pal1_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 8U, 32U);
+}
+
+YABMP_IAPI(void, yabmp_pal2_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 4U, 16U);
+}
+
+YABMP_IAPI(void, yabmp_pal4_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 2U, 8U);
+}
+
+YABMP_IAPI(void, yabmp_pal8_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
 {
 	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
+	const yabmp_uint32 *l_palette;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
+	l_palette = instance->palette_packed;
+	l_width   = (yabmp_uint32)instance->region_width;
 	
-	for(x = 0U; x < l_width / 8U; ++x)
+	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		
-		l_current = (l_value >> 7) & 0x01;
-		pDst[8*x+0] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 6) & 0x01;
-		pDst[8*x+1] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 5) & 0x01;
-		pDst[8*x+2] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 4) & 0x01;
-		pDst[8*x+3] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 3) & 0x01;
-		pDst[8*x+4] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 2) & 0x01;
-		pDst[8*x+5] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 1) & 0x01;
-		pDst[8*x+6] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 0) & 0x01;
-		pDst[8*x+7] = l_palette[l_current].blue;
-	}
-	
-	if (l_width & 7U) {
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		int l_remaining = (int)l_width & 7U;
-		
-		l_current = (l_value >> 7) & 0x01;
-		pDst[8*x+0] = l_palette[l_current].blue;
-		
-		if (l_remaining > 1) {
-			l_current = (l_value >> 6) & 0x01;
-			pDst[8*x+1] = l_palette[l_current].blue;
-		}
-		if (l_remaining > 2) {
-			l_current = (l_value >> 5) & 0x01;
-			pDst[8*x+2] = l_palette[l_current].blue;
-		}
-		if (l_remaining > 3) {
-			l_current = (l_value >> 4) & 0x01;
-			pDst[8*x+3] = l_palette[l_current].blue;
-		}
-		if (l_remaining > 4) {
-			l_current = (l_value >> 3) & 0x01;
-			pDst[8*x+4] = l_palette[l_current].blue;
-		}
-		if (l_remaining > 5) {
-			l_current = (l_value >> 2) & 0x01;
-			pDst[8*x+5] = l_palette[l_current].blue;
-		}
-		if (l_remaining > 6) {
-			l_current = (l_value >> 1) & 0x01;
-			pDst[8*x+6] = l_palette[l_current].blue;
-		}
+		local_store_le32(pDst + 4U * x, l_palette[pSrc[x]]);
 	}
 }
 
-YABMP_IAPI(void, yabmp_pal2_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+YABMP_IAPI(void, yabmp_bgr24_to_rgb24, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
 {
 	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
+	l_width = (yabmp_uint32)instance->region_width;
 	
-	for(x = 0U; x < l_width / 4U; ++x)
+	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		
-		l_current = (l_value >> 6) & 0x03;
-		pDst[4*x+0] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 4) & 0x03;
-		pDst[4*x+1] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 2) & 0x03;
-		pDst[4*x+2] = l_palette[l_current].blue;
-		
-		l_current = (l_value >> 0) & 0x03;
-		pDst[4*x+3] = l_palette[l_current].blue;
+		pDst[3*x+0] = pSrc[3*x+2];
+		pDst[3*x+1] = pSrc[3*x+1];
+		pDst[3*x+2] = pSrc[3*x+0];
 	}
+}
+
+YABMP_IAPI(void, yabmp_bgr24_to_bgra32, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width, l_alpha;
+	unsigned int l_shift_blue, l_shift_green, l_shift_red;
 	
-	if (l_width & 3U) {
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_current;
-		int l_remaining = (int)l_width & 3U;
-		
-		l_current = (l_value >> 6) & 0x03;
-		pDst[4*x+0] = l_palette[l_current].blue;
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width = (yabmp_uint32)instance->region_width;
+	l_shift_blue  = 0U;
+	l_shift_green = 8U;
+	l_shift_red   = 16U;
+	l_alpha       = 0xFF000000U;
+	if (instance->output_format & YABMP_OUTPUT_RGB) {
+		l_shift_blue = 16U;
+		l_shift_red  = 0U;
+	}
+	if (instance->output_format & YABMP_OUTPUT_ALPHA_FIRST) {
+		l_shift_blue  += 8U;
+		l_shift_green += 8U;
+		l_shift_red   += 8U;
+		l_alpha        = 0xFFU;
+	}
+	
+	for(x = 0U; x < l_width; ++x)
+	{
+		yabmp_uint32 l_color = l_alpha;
 		
-		if (l_remaining > 1) {
-			l_current = (l_value >> 4) & 0x03;
-			pDst[4*x+1] = l_palette[l_current].blue;
-		}
-		if (l_remaining > 2) {
-			l_current = (l_value >> 2) & 0x03;
-			pDst[4*x+2] = l_palette[l_current].blue;
-		}
+		l_color |= (yabmp_uint32)pSrc[3*x+0] << l_shift_blue;
+		l_color |= (yabmp_uint32)pSrc[3*x+1] << l_shift_green;
+		l_color |= (yabmp_uint32)pSrc[3*x+2] << l_shift_red;
+		local_store_le32(pDst + 4U * x, l_color);
 	}
 }
 
+YABMP_IAPI(void, yabmp_pal1_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 8U, 8U);
+}
+
+YABMP_IAPI(void, yabmp_pal2_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 4U, 4U);
+}
+
 YABMP_IAPI(void, yabmp_pal4_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_lut_expand(instance, pSrc, pDst, 2U, 2U);
+}
+
+YABMP_IAPI(void, yabmp_pal8_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
 {
 	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
+	const yabmp_uint8 *l_gray;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
+	l_gray  = instance->palette_gray;
+	l_width = (yabmp_uint32)instance->region_width;
 	
-	for(x = 0U; x < l_width / 2U; ++x)
+	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint8 l_value = pSrc[x];
-		yabmp_uint8 l_value_lo = l_value & 0x0F;
-		
-		l_value >>= 4;
-		pDst[2*x+0] = l_palette[l_value].blue;
-		pDst[2*x+1] = l_palette[l_value_lo].blue;
+		pDst[x] = l_gray[pSrc[x]];
 	}
+}
+
+YABMP_IAPI(void, yabmp_bgr24_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	yabmp_uint32 l_weight_blue, l_weight_green, l_weight_red;
 	
-	if (l_width & 1U) {
-		yabmp_uint8 l_value = pSrc[x] >> 4;
-		
-		pDst[2*x+0] = l_palette[l_value].blue;
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width        = (yabmp_uint32)instance->region_width;
+	l_weight_blue  = instance->luma_weights[0];
+	l_weight_green = instance->luma_weights[1];
+	l_weight_red   = instance->luma_weights[2];
+	
+	for(x = 0U; x < l_width; ++x)
+	{
+		pDst[x] = (yabmp_uint8)((l_weight_blue * pSrc[3*x+0] + l_weight_green * pSrc[3*x+1] + l_weight_red * pSrc[3*x+2] + 16384U) >> 15);
 	}
 }
 
-YABMP_IAPI(void, yabmp_pal8_to_y8, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+/* blue, green & red samples go through weighted full range tables, see local_setup_luma */
+static void local_bf_to_y8(const yabmp* instance, const void* pSrc, yabmp_uint8* pDst, unsigned int src_bytes)
 {
 	yabmp_uint32 x, l_width;
-	const yabmp_color *l_palette;
+	yabmp_uint32 l_mask0, l_mask1, l_mask2;
+	unsigned int l_shift0, l_shift1, l_shift2;
+	const yabmp_uint32 *l_lut0, *l_lut1, *l_lut2;
 	
 	assert(instance != NULL);
 	assert(pSrc != NULL);
 	assert(pDst != NULL);
 	
-	l_palette = instance->info2.palette;
-	l_width = (yabmp_uint32)instance->info2.width;
+	l_width  = (yabmp_uint32)instance->region_width;
+	l_mask0  = instance->out_mask[0];
+	l_mask1  = instance->out_mask[1];
+	l_mask2  = instance->out_mask[2];
+	l_shift0 = instance->out_shift[0];
+	l_shift1 = instance->out_shift[1];
+	l_shift2 = instance->out_shift[2];
+	l_lut0   = instance->luma_lut[0];
+	l_lut1   = instance->luma_lut[1];
+	l_lut2   = instance->luma_lut[2];
 	
 	for(x = 0U; x < l_width; ++x)
 	{
-		yabmp_uint8 l_value = pSrc[x];
+		yabmp_uint32 l_value = (src_bytes == 2U) ? ((const yabmp_uint16*)pSrc)[x] : ((const yabmp_uint32*)pSrc)[x];
 		
-		pDst[x] = l_palette[l_value].blue;
+		pDst[x] = (yabmp_uint8)((l_lut0[(l_value & l_mask0) >> l_shift0] + l_lut1[(l_value & l_mask1) >> l_shift1] + l_lut2[(l_value & l_mask2) >> l_shift2] + 16384U) >> 15);
 	}
 }
+
+YABMP_IAPI(void, yabmp_bf16u_to_y8, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_to_y8(instance, pSrc, pDst, 2U);
+}
+
+YABMP_IAPI(void, yabmp_bf32u_to_y8, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf_to_y8(instance, pSrc, pDst, 4U);
+}
@@ -0,0 +1,499 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Matthieu DARBOIS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <yabmp_config.h>
+
+#if defined(YABMP_HAVE_X86_SIMD)
+#	include <immintrin.h> /* before malloc gets poisoned */
+#endif
+
+#include "../inc/private/yabmp_internal.h"
+
+#if defined(YABMP_HAVE_X86_SIMD)
+
+YABMP_IAPI(unsigned int, yabmp_get_cpu_features, (void))
+{
+	unsigned int l_features = 0U;
+	
+	if (__builtin_cpu_supports("sse4.1")) {
+		l_features |= YABMP_CPU_SSE41;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		l_features |= YABMP_CPU_AVX2;
+	}
+	return l_features;
+}
+
+static void local_pal8_to_bgr24_tail(const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst, yabmp_uint32 x, yabmp_uint32 width)
+{
+	const yabmp_uint32 *l_palette = instance->palette_packed;
+	
+	for(; x < width; ++x)
+	{
+		yabmp_uint32 l_color = l_palette[pSrc[x]];
+		
+		pDst[3*x+0] = (yabmp_uint8)l_color;
+		pDst[3*x+1] = (yabmp_uint8)(l_color >> 8);
+		pDst[3*x+2] = (yabmp_uint8)(l_color >> 16);
+	}
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_pal8_to_bgr24_sse41, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	const yabmp_uint32 *l_palette;
+	__m128i l_pack;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_palette = instance->palette_packed;
+	l_width   = (yabmp_uint32)instance->region_width;
+	l_pack    = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	
+	/* 16 bytes are stored for 4 pixels, keep the 4 extra bytes inside the row */
+	for(x = 0U; (x + 6U) <= l_width; x += 4U)
+	{
+		__m128i l_pixels;
+		
+		l_pixels = _mm_cvtsi32_si128((int)l_palette[pSrc[x+0]]);
+		l_pixels = _mm_insert_epi32(l_pixels, (int)l_palette[pSrc[x+1]], 1);
+		l_pixels = _mm_insert_epi32(l_pixels, (int)l_palette[pSrc[x+2]], 2);
+		l_pixels = _mm_insert_epi32(l_pixels, (int)l_palette[pSrc[x+3]], 3);
+		_mm_storeu_si128((__m128i*)(pDst + 3U * x), _mm_shuffle_epi8(l_pixels, l_pack));
+	}
+	local_pal8_to_bgr24_tail(instance, pSrc, pDst, x, l_width);
+}
+
+__attribute__((target("avx2")))
+YABMP_IAPI(void, yabmp_pal8_to_bgr24_avx2, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	const yabmp_uint32 *l_palette;
+	__m256i l_pack;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_palette = instance->palette_packed;
+	l_width   = (yabmp_uint32)instance->region_width;
+	l_pack    = _mm256_setr_epi8(
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+	);
+	
+	/* 28 bytes are stored for 8 pixels, keep the 4 extra bytes inside the row */
+	for(x = 0U; (x + 10U) <= l_width; x += 8U)
+	{
+		__m256i l_indices, l_pixels;
+		
+		l_indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(pSrc + x)));
+		l_pixels  = _mm256_i32gather_epi32((const int*)l_palette, l_indices, 4);
+		l_pixels  = _mm256_shuffle_epi8(l_pixels, l_pack);
+		_mm_storeu_si128((__m128i*)(pDst + 3U * x), _mm256_castsi256_si128(l_pixels));
+		_mm_storeu_si128((__m128i*)(pDst + 3U * x + 12U), _mm256_extracti128_si256(l_pixels, 1));
+	}
+	local_pal8_to_bgr24_tail(instance, pSrc, pDst, x, l_width);
+}
+
+/* 5 bits blue & red, green_bits bits green, red may come first, optionally scaled to full range by bit replication */
+/* opaque alpha is added last with 4 channels */
+__attribute__((target("sse4.1")))
+static void local_bf16u_to_bgr_sse41(const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst, int green_bits, int scale, unsigned int channels)
+{
+	yabmp_uint32 x, l_width;
+	unsigned int l_shift0, l_shift2;
+	__m128i l_pack, l_mask, l_green_mask, l_alpha, l_count0, l_count2;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width      = (yabmp_uint32)instance->region_width;
+	l_shift0     = instance->out_shift[0];
+	l_shift2     = instance->out_shift[2];
+	l_pack       = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+	l_mask       = _mm_set1_epi16(0x1F);
+	l_green_mask = _mm_set1_epi16((short)((1 << green_bits) - 1));
+	l_alpha      = _mm_set1_epi16((short)0xFF00);
+	l_count0     = _mm_cvtsi32_si128((int)l_shift0);
+	l_count2     = _mm_cvtsi32_si128((int)l_shift2);
+	
+	/* 28 bytes are stored for 8 pixels with 3 channels, keep the 4 extra bytes inside the row */
+	for(x = 0U; (x + ((channels == 4U) ? 8U : 10U)) <= l_width; x += 8U)
+	{
+		__m128i l_pixels, l_value0, l_green, l_value2, l_value01;
+		
+		l_pixels = _mm_loadu_si128((const __m128i*)(pSrc + x));
+		l_value0 = _mm_and_si128(_mm_srl_epi16(l_pixels, l_count0), l_mask);
+		l_green  = _mm_and_si128(_mm_srli_epi16(l_pixels, 5), l_green_mask);
+		l_value2 = _mm_and_si128(_mm_srl_epi16(l_pixels, l_count2), l_mask);
+		if (scale) {
+			l_value0 = _mm_or_si128(_mm_slli_epi16(l_value0, 3), _mm_srli_epi16(l_value0, 2));
+			l_green  = _mm_or_si128(_mm_slli_epi16(l_green, 8 - green_bits), _mm_srli_epi16(l_green, 2 * green_bits - 8));
+			l_value2 = _mm_or_si128(_mm_slli_epi16(l_value2, 3), _mm_srli_epi16(l_value2, 2));
+		}
+		l_value01 = _mm_or_si128(l_value0, _mm_slli_epi16(l_green, 8));
+		
+		if (channels == 4U) {
+			l_value2 = _mm_or_si128(l_value2, l_alpha);
+			_mm_storeu_si128((__m128i*)(pDst + 4U * x), _mm_unpacklo_epi16(l_value01, l_value2));
+			_mm_storeu_si128((__m128i*)(pDst + 4U * x + 16U), _mm_unpackhi_epi16(l_value01, l_value2));
+		} else {
+			_mm_storeu_si128((__m128i*)(pDst + 3U * x), _mm_shuffle_epi8(_mm_unpacklo_epi16(l_value01, l_value2), l_pack));
+			_mm_storeu_si128((__m128i*)(pDst + 3U * x + 12U), _mm_shuffle_epi8(_mm_unpackhi_epi16(l_value01, l_value2), l_pack));
+		}
+	}
+	for(; x < l_width; ++x)
+	{
+		yabmp_uint32 l_value  = pSrc[x];
+		yabmp_uint32 l_value0 = (l_value >> l_shift0) & 0x1FU;
+		yabmp_uint32 l_green  = (l_value >> 5) & ((1U << green_bits) - 1U);
+		yabmp_uint32 l_value2 = (l_value >> l_shift2) & 0x1FU;
+		
+		if (scale) {
+			l_value0 = (l_value0 << 3) | (l_value0 >> 2);
+			l_green  = (l_green << (8 - green_bits)) | (l_green >> (2 * green_bits - 8));
+			l_value2 = (l_value2 << 3) | (l_value2 >> 2);
+		}
+		pDst[channels*x+0] = (yabmp_uint8)l_value0;
+		pDst[channels*x+1] = (yabmp_uint8)l_green;
+		pDst[channels*x+2] = (yabmp_uint8)l_value2;
+		if (channels == 4U) {
+			pDst[channels*x+3] = 0xFFU;
+		}
+	}
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 6, 0, 3U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 5, 0, 3U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgr24_scaled_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 6, 1, 3U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgr24_scaled_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 5, 1, 3U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 6, 0, 4U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 5, 0, 4U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_565_to_bgra32_scaled_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 6, 1, 4U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf16u_555_to_bgra32_scaled_sse41, (const yabmp* instance, const yabmp_uint16* pSrc, yabmp_uint8* pDst ))
+{
+	local_bf16u_to_bgr_sse41(instance, pSrc, pDst, 5, 1, 4U);
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf32u_x8r8g8b8_to_bgr24_sse41, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	unsigned int l_shift0, l_shift2;
+	char l_byte0, l_byte2;
+	__m128i l_pack;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width  = (yabmp_uint32)instance->region_width;
+	l_shift0 = instance->out_shift[0];
+	l_shift2 = instance->out_shift[2];
+	l_byte0  = (char)(l_shift0 / 8U);
+	l_byte2  = (char)(l_shift2 / 8U);
+	l_pack   = _mm_setr_epi8(l_byte0, 1, l_byte2, l_byte0 + 4, 5, l_byte2 + 4, l_byte0 + 8, 9, l_byte2 + 8, l_byte0 + 12, 13, l_byte2 + 12, -1, -1, -1, -1);
+	
+	/* 16 bytes are stored for 4 pixels, keep the 4 extra bytes inside the row */
+	for(x = 0U; (x + 6U) <= l_width; x += 4U)
+	{
+		_mm_storeu_si128((__m128i*)(pDst + 3U * x), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pSrc + x)), l_pack));
+	}
+	for(; x < l_width; ++x)
+	{
+		yabmp_uint32 l_value = pSrc[x];
+		
+		pDst[3*x+0] = (yabmp_uint8)(l_value >> l_shift0);
+		pDst[3*x+1] = (yabmp_uint8)(l_value >> 8);
+		pDst[3*x+2] = (yabmp_uint8)(l_value >> l_shift2);
+	}
+}
+
+/* 8 bits channels on byte boundaries, reordered with out_shift, out_fill sets opaque alpha for x8r8g8b8 */
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf32u_8888_swizzle_sse41, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width, l_fill;
+	unsigned int c;
+	char l_bytes[4];
+	__m128i l_swizzle, l_fill128;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width = (yabmp_uint32)instance->region_width;
+	l_fill  = 0U;
+	for (c = 0U; c < 4U; ++c) {
+		l_bytes[c] = (char)(instance->out_shift[c] / 8U);
+		l_fill |= (instance->out_fill[c] & 0xFFU) << (8U * c);
+	}
+	l_swizzle = _mm_setr_epi8(
+		l_bytes[0],      l_bytes[1],      l_bytes[2],      l_bytes[3],
+		l_bytes[0] + 4,  l_bytes[1] + 4,  l_bytes[2] + 4,  l_bytes[3] + 4,
+		l_bytes[0] + 8,  l_bytes[1] + 8,  l_bytes[2] + 8,  l_bytes[3] + 8,
+		l_bytes[0] + 12, l_bytes[1] + 12, l_bytes[2] + 12, l_bytes[3] + 12);
+	l_fill128 = _mm_set1_epi32((int)l_fill);
+	
+	for(x = 0U; (x + 4U) <= l_width; x += 4U)
+	{
+		__m128i l_pixels = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pSrc + x)), l_swizzle);
+		
+		_mm_storeu_si128((__m128i*)(pDst + 4U * x), _mm_or_si128(l_pixels, l_fill128));
+	}
+	for(; x < l_width; ++x)
+	{
+		yabmp_uint32 l_value = pSrc[x];
+		
+		for (c = 0U; c < 4U; ++c) {
+			pDst[4*x+c] = (yabmp_uint8)((l_value >> instance->out_shift[c]) | instance->out_fill[c]);
+		}
+	}
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bgr24_to_rgb24_sse41, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	__m128i l_swap;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width = (yabmp_uint32)instance->region_width;
+	l_swap  = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+	
+	/* 16 bytes are loaded & stored for 5 pixels, keep the extra byte inside the row */
+	for(x = 0U; (x + 6U) <= l_width; x += 5U)
+	{
+		_mm_storeu_si128((__m128i*)(pDst + 3U * x), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pSrc + 3U * x)), l_swap));
+	}
+	for(; x < l_width; ++x)
+	{
+		pDst[3*x+0] = pSrc[3*x+2];
+		pDst[3*x+1] = pSrc[3*x+1];
+		pDst[3*x+2] = pSrc[3*x+0];
+	}
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bgr24_to_bgra32_sse41, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	unsigned int l_pos[3], l_pos_alpha, i, c;
+	char l_indices[16];
+	__m128i l_expand, l_alpha;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width = (yabmp_uint32)instance->region_width;
+	
+	/* output byte of blue, green, red & alpha */
+	l_pos[0] = 0U;
+	l_pos[1] = 1U;
+	l_pos[2] = 2U;
+	l_pos_alpha = 3U;
+	if (instance->output_format & YABMP_OUTPUT_RGB) {
+		l_pos[0] = 2U;
+		l_pos[2] = 0U;
+	}
+	if (instance->output_format & YABMP_OUTPUT_ALPHA_FIRST) {
+		l_pos[0]++;
+		l_pos[1]++;
+		l_pos[2]++;
+		l_pos_alpha = 0U;
+	}
+	for (i = 0U; i < 4U; ++i) {
+		for (c = 0U; c < 3U; ++c) {
+			l_indices[4U * i + l_pos[c]] = (char)(3U * i + c);
+		}
+		l_indices[4U * i + l_pos_alpha] = -1;
+	}
+	l_expand = _mm_loadu_si128((const __m128i*)l_indices);
+	l_alpha  = _mm_set1_epi32((int)(0xFFU << (8U * l_pos_alpha)));
+	
+	/* 16 bytes are loaded for 4 pixels, keep the 4 extra bytes inside the row */
+	for(x = 0U; (x + 6U) <= l_width; x += 4U)
+	{
+		__m128i l_pixels = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(pSrc + 3U * x)), l_expand);
+		
+		_mm_storeu_si128((__m128i*)(pDst + 4U * x), _mm_or_si128(l_pixels, l_alpha));
+	}
+	for(; x < l_width; ++x)
+	{
+		for (c = 0U; c < 3U; ++c) {
+			pDst[4U * x + l_pos[c]] = pSrc[3U * x + c];
+		}
+		pDst[4U * x + l_pos_alpha] = 0xFFU;
+	}
+}
+
+__attribute__((target("avx2")))
+YABMP_IAPI(void, yabmp_pal8_to_bgra32_avx2, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	yabmp_uint32 x, l_width;
+	const yabmp_uint32 *l_palette;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_palette = instance->palette_packed;
+	l_width   = (yabmp_uint32)instance->region_width;
+	
+	for(x = 0U; (x + 8U) <= l_width; x += 8U)
+	{
+		__m256i l_indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(pSrc + x)));
+		
+		_mm256_storeu_si256((__m256i*)(pDst + 4U * x), _mm256_i32gather_epi32((const int*)l_palette, l_indices, 4));
+	}
+	for(; x < l_width; ++x)
+	{
+		yabmp_uint32 l_color = l_palette[pSrc[x]];
+		
+		memcpy(pDst + 4U * x, &l_color, sizeof(l_color));
+	}
+}
+
+/* blue, green & red bytes at given offsets in pixel_bytes bytes pixels, weighted with 15 bits fixed point luma_weights */
+__attribute__((target("sse4.1")))
+static void local_rgb_to_y8_sse41(const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst, unsigned int pixel_bytes, unsigned int offset_blue, unsigned int offset_green, unsigned int offset_red)
+{
+	yabmp_uint32 x, l_width;
+	yabmp_uint32 l_weight_blue, l_weight_green, l_weight_red;
+	unsigned int i;
+	char l_indices_bg[16], l_indices_r[16];
+	__m128i l_shuffle_bg, l_shuffle_r, l_one, l_weights_bg, l_weights_r;
+	
+	assert(instance != NULL);
+	assert(pSrc != NULL);
+	assert(pDst != NULL);
+	
+	l_width        = (yabmp_uint32)instance->region_width;
+	l_weight_blue  = instance->luma_weights[0];
+	l_weight_green = instance->luma_weights[1];
+	l_weight_red   = instance->luma_weights[2];
+	
+	/* 4 pixels per register, 32 bits lanes hold blue & green or red & 1 as 16 bits samples */
+	for (i = 0U; i < 4U; ++i) {
+		l_indices_bg[4U * i + 0U] = (char)(pixel_bytes * i + offset_blue);
+		l_indices_bg[4U * i + 1U] = -1;
+		l_indices_bg[4U * i + 2U] = (char)(pixel_bytes * i + offset_green);
+		l_indices_bg[4U * i + 3U] = -1;
+		l_indices_r[4U * i + 0U]  = (char)(pixel_bytes * i + offset_red);
+		l_indices_r[4U * i + 1U]  = -1;
+		l_indices_r[4U * i + 2U]  = -1;
+		l_indices_r[4U * i + 3U]  = -1;
+	}
+	l_shuffle_bg = _mm_loadu_si128((const __m128i*)l_indices_bg);
+	l_shuffle_r  = _mm_loadu_si128((const __m128i*)l_indices_r);
+	l_one        = _mm_set1_epi32(0x00010000);
+	l_weights_bg = _mm_set1_epi32((int)(l_weight_blue | (l_weight_green << 16)));
+	l_weights_r  = _mm_set1_epi32((int)(l_weight_red | (16384U << 16))); /* rounding */
+	
+	/* 16 bytes are loaded for the last 4 pixels, keep the extra bytes inside the row */
+	for(x = 0U; (x + ((pixel_bytes == 4U) ? 8U : 10U)) <= l_width; x += 8U)
+	{
+		__m128i l_pixels_lo, l_pixels_hi, l_luma_lo, l_luma_hi;
+		
+		l_pixels_lo = _mm_loadu_si128((const __m128i*)(pSrc + pixel_bytes * x));
+		l_pixels_hi = _mm_loadu_si128((const __m128i*)(pSrc + pixel_bytes * (x + 4U)));
+		l_luma_lo = _mm_add_epi32(
+			_mm_madd_epi16(_mm_shuffle_epi8(l_pixels_lo, l_shuffle_bg), l_weights_bg),
+			_mm_madd_epi16(_mm_or_si128(_mm_shuffle_epi8(l_pixels_lo, l_shuffle_r), l_one), l_weights_r));
+		l_luma_hi = _mm_add_epi32(
+			_mm_madd_epi16(_mm_shuffle_epi8(l_pixels_hi, l_shuffle_bg), l_weights_bg),
+			_mm_madd_epi16(_mm_or_si128(_mm_shuffle_epi8(l_pixels_hi, l_shuffle_r), l_one), l_weights_r));
+		l_luma_lo = _mm_packs_epi32(_mm_srli_epi32(l_luma_lo, 15), _mm_srli_epi32(l_luma_hi, 15));
+		_mm_storel_epi64((__m128i*)(pDst + x), _mm_packus_epi16(l_luma_lo, l_luma_lo));
+	}
+	for(; x < l_width; ++x)
+	{
+		const yabmp_uint8* l_pixel = pSrc + pixel_bytes * x;
+		
+		pDst[x] = (yabmp_uint8)((l_weight_blue * l_pixel[offset_blue] + l_weight_green * l_pixel[offset_green] + l_weight_red * l_pixel[offset_red] + 16384U) >> 15);
+	}
+}
+
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bgr24_to_y8_sse41, (const yabmp* instance, const yabmp_uint8* pSrc, yabmp_uint8* pDst ))
+{
+	local_rgb_to_y8_sse41(instance, pSrc, pDst, 3U, 0U, 1U, 2U);
+}
+
+/* 8 bits channels on byte boundaries */
+__attribute__((target("sse4.1")))
+YABMP_IAPI(void, yabmp_bf32u_8888_to_y8_sse41, (const yabmp* instance, const yabmp_uint32* pSrc, yabmp_uint8* pDst ))
+{
+	local_rgb_to_y8_sse41(instance, (const yabmp_uint8*)pSrc, pDst, 4U, instance->out_shift[0] / 8U, instance->out_shift[1] / 8U, instance->out_shift[2] / 8U);
+}
+
+#else
+typedef int yabmp_rtransforms_x86_empty; /* ISO C forbids an empty translation unit */
+#endif
@@ -26,6 +26,14 @@
 
 #include "../inc/private/yabmp_internal.h"
 
+#if defined(YABMP_HAVE_MMAP)
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#	include <sys/mman.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
 /* FILE stream helper */
 static size_t yabmp_file_read (void* context, void * ptr, size_t size)
 {
@@ -132,6 +140,53 @@ BADEND:
 	return l_status;
 }
 
+YABMP_IAPI(size_t, yabmp_stream_fetch, (yabmp* reader, void* buffer, size_t buffer_len))
+{
+	yabmp_uint8* l_buffer = (yabmp_uint8*)buffer;
+	size_t l_count = 0U;
+	
+	assert(reader != NULL);
+	assert(reader->read_fn != NULL);
+	
+	if ((reader->read_buffer == NULL) || (reader->input_data != NULL) || (reader->push_row_fn != NULL)) {
+		/* no read-ahead for memory or push input, data is already there */
+		l_count = reader->read_fn(reader->stream_context, l_buffer, buffer_len);
+	}
+	else {
+		size_t l_available = reader->read_buffer_len - reader->read_buffer_pos;
+		
+		if (l_available > buffer_len) {
+			l_available = buffer_len;
+		}
+		memcpy(l_buffer, reader->read_buffer + reader->read_buffer_pos, l_available);
+		reader->read_buffer_pos += l_available;
+		l_count = l_available;
+		
+		if (l_count < buffer_len) {
+			/* read-ahead buffer is empty */
+			reader->read_buffer_pos = 0U;
+			reader->read_buffer_len = 0U;
+			
+			if ((buffer_len - l_count) >= reader->read_buffer_size) {
+				/* big request, no need to go through the read-ahead buffer */
+				l_count += reader->read_fn(reader->stream_context, l_buffer + l_count, buffer_len - l_count);
+			}
+			else {
+				reader->read_buffer_len = reader->read_fn(reader->stream_context, reader->read_buffer, reader->read_buffer_size);
+				l_available = reader->read_buffer_len;
+				if (l_available > (buffer_len - l_count)) {
+					l_available = buffer_len - l_count;
+				}
+				memcpy(l_buffer + l_count, reader->read_buffer, l_available);
+				reader->read_buffer_pos = l_available;
+				l_count += l_available;
+			}
+		}
+	}
+	reader->stream_offset += (yabmp_uint32)l_count;
+	return l_count;
+}
+
 YABMP_IAPI(yabmp_status, yabmp_stream_read, (yabmp* reader, yabmp_uint8* buffer, size_t buffer_len))
 {
 	yabmp_status l_status = YABMP_OK;
@@ -139,15 +194,58 @@ YABMP_IAPI(yabmp_status, yabmp_stream_read, (yabmp* reader, yabmp_uint8* buffer,
 	assert(reader != NULL);
 	assert(reader->kind == YABMP_KIND_READER);
 	
-	if (reader->read_fn(reader->stream_context, buffer, buffer_len) != buffer_len) {
+	if (yabmp_stream_fetch(reader, buffer, buffer_len) != buffer_len) {
 		yabmp_send_error(reader, "Failed to read %zu bytes.", buffer_len);
 		l_status = YABMP_ERR_UNKNOW;
-	} else {
-		reader->stream_offset += (yabmp_uint32)buffer_len;
 	}
 	return l_status;
 }
 
+YABMP_IAPI(size_t, yabmp_stream_window, (yabmp* reader, const yabmp_uint8** data))
+{
+	assert(reader != NULL);
+	assert(data != NULL);
+	
+	*data = NULL;
+	if (reader->input_data != NULL) {
+		if ((size_t)reader->stream_offset >= reader->input_data_size) {
+			return 0U;
+		}
+		*data = reader->input_data + reader->stream_offset;
+		return reader->input_data_size - (size_t)reader->stream_offset;
+	}
+	if (reader->push_row_fn != NULL) {
+		size_t l_offset = (size_t)(reader->stream_offset - reader->push_buffer_offset);
+		
+		if (l_offset >= reader->push_buffer_len) {
+			return 0U;
+		}
+		*data = reader->push_buffer + l_offset;
+		return reader->push_buffer_len - l_offset;
+	}
+	if (reader->read_buffer == NULL) {
+		return 0U;
+	}
+	if (reader->read_buffer_pos == reader->read_buffer_len) {
+		/* read-ahead buffer is empty */
+		reader->read_buffer_pos = 0U;
+		reader->read_buffer_len = reader->read_fn(reader->stream_context, reader->read_buffer, reader->read_buffer_size);
+	}
+	*data = reader->read_buffer + reader->read_buffer_pos;
+	return reader->read_buffer_len - reader->read_buffer_pos;
+}
+
+YABMP_IAPI(void, yabmp_stream_consume, (yabmp* reader, size_t count))
+{
+	assert(reader != NULL);
+	
+	if ((reader->read_buffer != NULL) && (reader->input_data == NULL) && (reader->push_row_fn == NULL)) {
+		assert(count <= (reader->read_buffer_len - reader->read_buffer_pos));
+		reader->read_buffer_pos += count;
+	}
+	reader->stream_offset += (yabmp_uint32)count;
+}
+
 YABMP_IAPI(yabmp_status, yabmp_stream_seek, (yabmp* reader, yabmp_uint32 offset)) /* max offset is on yabmp_uint32 for BMP */
 {
 	yabmp_status l_status = YABMP_OK;
@@ -155,9 +253,22 @@ YABMP_IAPI(yabmp_status, yabmp_stream_seek, (yabmp* reader, yabmp_uint32 offset)
 	assert(reader != NULL);
 	assert(reader->kind == YABMP_KIND_READER);
 	
+	if (reader->read_buffer_len > 0U) {
+		/* offset of the first byte in read-ahead buffer */
+		yabmp_uint32 l_base = reader->stream_offset - (yabmp_uint32)reader->read_buffer_pos;
+		
+		if ((offset >= l_base) && ((size_t)(offset - l_base) <= reader->read_buffer_len)) {
+			reader->read_buffer_pos = (size_t)(offset - l_base);
+			reader->stream_offset = offset;
+			return YABMP_OK;
+		}
+	}
+	
 	l_status = reader->seek_fn(reader->stream_context, offset);
 	if (l_status == YABMP_OK) {
 		reader->stream_offset = offset;
+		reader->read_buffer_pos = 0U;
+		reader->read_buffer_len = 0U;
 	} else {
 		yabmp_send_error(reader, "Failed to seek to position %" YABMP_PRIu32 ".", offset);
 	}
@@ -178,7 +289,11 @@ YABMP_IAPI(yabmp_status, yabmp_stream_skip, (yabmp* instance, yabmp_uint32 count
 			l_status = YABMP_ERR_UNKNOW;
 			goto BADEND;
 		}
-		if (instance->seek_fn != NULL) {
+		if ((size_t)count <= (instance->read_buffer_len - instance->read_buffer_pos)) {
+			instance->read_buffer_pos += (size_t)count;
+			instance->stream_offset += count;
+		}
+		else if (instance->seek_fn != NULL) {
 			l_status = yabmp_stream_seek(instance, instance->stream_offset + count);
 		}
 		else {
@@ -187,11 +302,10 @@ YABMP_IAPI(yabmp_status, yabmp_stream_skip, (yabmp* instance, yabmp_uint32 count
 				if (count < 32U) {
 					l_count = (size_t)count;
 				}
-				if (instance->read_fn(instance->stream_context, l_buffer, l_count) != l_count) {
+				if (yabmp_stream_fetch(instance, l_buffer, l_count) != l_count) {
 					l_status = YABMP_ERR_UNKNOW;
 					goto BADEND;
 				} else {
-					instance->stream_offset += (yabmp_uint32)l_count;
 					count -= (yabmp_uint32)l_count;
 				}
 			}
@@ -201,58 +315,141 @@ BADEND:
 	return l_status;
 }
 
-/* Input memory stream */
-typedef struct
+YABMP_IAPI(yabmp_status, yabmp_stream_read_8u, (yabmp* instance, yabmp_uint8* value))
 {
-	yabmp*             reader;
-	const yabmp_uint8* data;
-	const yabmp_uint8* current;
-	size_t             data_size;
-} yabmp_input_memory_stream;
+	yabmp_status l_status = YABMP_OK;
+	
+	assert(instance != NULL);
+	assert(value != NULL);
+	assert(instance->read_fn != NULL);
+	
+	/* fast path, byte already in read-ahead buffer */
+	if (instance->read_buffer_pos < instance->read_buffer_len) {
+		*value = instance->read_buffer[instance->read_buffer_pos++];
+		instance->stream_offset += 1U;
+	} else if (yabmp_stream_fetch(instance, value, 1U) != 1U) {
+		l_status = YABMP_ERR_UNKNOW;
+	}
+	return l_status;
+}
 
+YABMP_IAPI(yabmp_status, yabmp_stream_read_le_16u, (yabmp* instance, yabmp_uint16* value))
+{
+	yabmp_status l_status = YABMP_OK;
+	
+	assert(instance != NULL);
+	assert(value != NULL);
+	assert(instance->read_fn != NULL);
+	/* if we're on a little endian machine, just read directly */
+	if (yabmp_stream_fetch(instance, value, 2U) != 2U) {
+		l_status = YABMP_ERR_UNKNOW;
+	} else {
+#if defined(YABMP_BIG_ENDIAN)
+		*value = yabmp_bswap16(*value);
+#endif
+	}
+	return l_status;
+}
+
+YABMP_IAPI(yabmp_status, yabmp_stream_read_le_32u, (yabmp* instance, yabmp_uint32* value))
+{
+	yabmp_status l_status = YABMP_OK;
+	
+	assert(instance != NULL);
+	assert(value != NULL);
+	assert(instance->read_fn != NULL);
+	/* if we're on a little endian machine, just read directly */
+	if (yabmp_stream_fetch(instance, value, 4U) != 4U) {
+		l_status = YABMP_ERR_UNKNOW;
+	} else {
+#if defined(YABMP_BIG_ENDIAN)
+		*value = yabmp_bswap32(*value);
+#endif
+	}
+	return l_status;
+}
+
+YABMP_API(yabmp_status, yabmp_set_read_buffer_size, (yabmp* reader, size_t buffer_size))
+{
+	yabmp_uint8* l_buffer = NULL;
+	size_t l_pending;
+	
+	YABMP_CHECK_READER(reader);
+	
+	l_pending = reader->read_buffer_len - reader->read_buffer_pos;
+	
+	if (buffer_size == reader->read_buffer_size) {
+		return YABMP_OK;
+	}
+	if (buffer_size < l_pending) {
+		/* data already read from stream would be lost, go back to where we're supposed to be */
+		if (reader->seek_fn == NULL) {
+			yabmp_send_error(reader, "Can't shrink read-ahead buffer below %zu bytes without a seek function.", l_pending);
+			return YABMP_ERR_UNKNOW;
+		}
+		if (reader->seek_fn(reader->stream_context, reader->stream_offset) != YABMP_OK) {
+			yabmp_send_error(reader, "Failed to seek to position %" YABMP_PRIu32 ".", reader->stream_offset);
+			return YABMP_ERR_UNKNOW;
+		}
+		l_pending = 0U;
+	}
+	
+	if (buffer_size > 0U) {
+		l_buffer = (yabmp_uint8*)yabmp_malloc(reader, buffer_size);
+		if (l_buffer == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+		if (l_pending > 0U) {
+			memcpy(l_buffer, reader->read_buffer + reader->read_buffer_pos, l_pending);
+		}
+	}
+	yabmp_free(reader, reader->read_buffer);
+	reader->read_buffer = l_buffer;
+	reader->read_buffer_size = buffer_size;
+	reader->read_buffer_pos = 0U;
+	reader->read_buffer_len = l_pending;
+	
+	return YABMP_OK;
+}
+
+/* Input memory stream, context is the reader itself */
 static size_t yabmp_memory_read (void* context, void * ptr, size_t size)
 {
-	yabmp_input_memory_stream* l_context = (yabmp_input_memory_stream*)context;
+	yabmp* l_reader = (yabmp*)context;
 	size_t l_remaining;
 	
-	assert(l_context != NULL);
+	assert(l_reader != NULL);
+	assert(l_reader->input_data != NULL);
 	
-	l_remaining = l_context->data_size - (size_t)(l_context->current - l_context->data);
+	if ((size_t)l_reader->stream_offset >= l_reader->input_data_size) {
+		return 0U;
+	}
+	l_remaining = l_reader->input_data_size - (size_t)l_reader->stream_offset;
 	if (size > l_remaining) {
 		size = l_remaining;
 	}
 	if (size) {
-		memcpy(ptr, l_context->current, size);
-		l_context->current += size;
+		memcpy(ptr, l_reader->input_data + l_reader->stream_offset, size);
 	}
 	return size;
 }
 
 static yabmp_status yabmp_memory_seek(void* context, yabmp_uint32 offset)
 {
-	yabmp_input_memory_stream* l_context = (yabmp_input_memory_stream*)context;
+	yabmp* l_reader = (yabmp*)context;
 	
-	assert(l_context != NULL);
+	assert(l_reader != NULL);
+	assert(l_reader->input_data != NULL);
 	
-	if ((size_t)offset > l_context->data_size) {
+	if ((size_t)offset > l_reader->input_data_size) {
 		return YABMP_ERR_UNKNOW;
 	}
-	l_context->current = l_context->data + offset;
 	return YABMP_OK;
 }
-static void yabmp_memory_close(void* context)
-{
-	yabmp_input_memory_stream* l_context = (yabmp_input_memory_stream*)context;
-	yabmp* l_reader = NULL;
-	assert(l_context != NULL);
-	l_reader = l_context->reader;
-	yabmp_free(l_reader, l_context);
-}
 
 YABMP_API(yabmp_status, yabmp_set_input_memory, (yabmp* reader, const void* data, size_t data_size))
 {
 	yabmp_status l_status = YABMP_OK;
-	yabmp_input_memory_stream* l_context = NULL;
 	YABMP_CHECK_READER(reader);
 	
 	if (data == NULL) {
@@ -260,24 +457,272 @@ YABMP_API(yabmp_status, yabmp_set_input_memory, (yabmp* reader, const void* data
 		return YABMP_ERR_INVALID_ARGS;
 	}
 	
-	l_context = (yabmp_input_memory_stream*)yabmp_malloc(reader, sizeof(*l_context));
-	if (l_context == NULL) {
-		l_status = YABMP_ERR_ALLOCATION;
-		goto BADEND;
+	/* memory read & seek functions use stream_offset as their current position */
+	l_status = yabmp_set_input_stream(reader, (void*)reader, yabmp_memory_read, yabmp_memory_seek, NULL);
+	if (l_status == YABMP_OK) {
+		reader->input_data = (const yabmp_uint8*)data;
+		reader->input_data_size = data_size;
+	}
+	return l_status;
+}
+
+YABMP_IAPI(yabmp_status, yabmp_stream_read_at, (yabmp* reader, yabmp_uint32 offset, yabmp_uint8* buffer, size_t buffer_len))
+{
+	yabmp_status l_status = YABMP_OK;
+	
+	assert(reader != NULL);
+	assert(reader->kind == YABMP_KIND_READER);
+	
+	if (reader->input_data != NULL) {
+		if (((size_t)offset > reader->input_data_size) || ((reader->input_data_size - (size_t)offset) < buffer_len)) {
+			l_status = YABMP_ERR_UNKNOW;
+		} else {
+			memcpy(buffer, reader->input_data + offset, buffer_len);
+		}
+	}
+	else if (reader->read_at_fn != NULL) {
+		if (reader->read_at_fn(reader->read_at_context, offset, buffer, buffer_len) != buffer_len) {
+			l_status = YABMP_ERR_UNKNOW;
+		}
+	}
+	else {
+		yabmp_uint32 l_offset = reader->stream_offset;
+		
+		YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, offset));
+		l_status = yabmp_stream_read(reader, buffer, buffer_len);
+		YABMP_SIMPLE_CHECK(yabmp_stream_seek(reader, l_offset));
+		return l_status;
+	}
+	if (l_status != YABMP_OK) {
+		yabmp_send_error(reader, "Failed to read %zu bytes.", buffer_len);
+	}
+	return l_status;
+}
+
+/* Input positional stream, context is the reader itself */
+static size_t yabmp_positional_read(void* context, void * ptr, size_t size)
+{
+	yabmp* l_reader = (yabmp*)context;
+	size_t l_count;
+	
+	assert(l_reader != NULL);
+	assert(l_reader->read_at_fn != NULL);
+	
+	l_count = l_reader->read_at_fn(l_reader->read_at_context, l_reader->read_at_offset, ptr, size);
+	l_reader->read_at_offset += (yabmp_uint32)l_count;
+	return l_count;
+}
+
+static yabmp_status yabmp_positional_seek(void* context, yabmp_uint32 offset)
+{
+	yabmp* l_reader = (yabmp*)context;
+	
+	assert(l_reader != NULL);
+	
+	/* nothing to do until next read */
+	l_reader->read_at_offset = offset;
+	return YABMP_OK;
+}
+
+static void yabmp_positional_close(void* context)
+{
+	yabmp* l_reader = (yabmp*)context;
+	
+	assert(l_reader != NULL);
+	
+	if (l_reader->read_at_close_fn != NULL) {
+		l_reader->read_at_close_fn(l_reader->read_at_context);
 	}
+}
+
+YABMP_API(yabmp_status, yabmp_set_input_stream_positional, (yabmp* reader, void* stream_context, yabmp_stream_read_at_cb read_at_fn, yabmp_stream_close_cb close_fn))
+{
+	yabmp_status l_status = YABMP_OK;
+	YABMP_CHECK_READER(reader);
 	
-	l_context->reader = reader;
-	l_context->data = data;
-	l_context->current = data;
-	l_context->data_size = data_size;
+	if (read_at_fn == NULL) {
+		yabmp_send_error(reader, "NULL read_at function.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
 	
-	l_status = yabmp_set_input_stream(reader, (void*)l_context, yabmp_memory_read, yabmp_memory_seek, yabmp_memory_close);
+	/* positional read & seek functions keep their own position, reads don't depend on user stream state */
+	l_status = yabmp_set_input_stream(reader, (void*)reader, yabmp_positional_read, yabmp_positional_seek, yabmp_positional_close);
 	if (l_status == YABMP_OK) {
-		l_context = NULL;
+		reader->read_at_fn = read_at_fn;
+		reader->read_at_close_fn = close_fn;
+		reader->read_at_context = stream_context;
+		reader->read_at_offset = 0U;
 	}
-BADEND:
-	if (l_context != NULL) {
-		yabmp_free(reader, l_context);
+	return l_status;
+}
+
+/* Input push buffer, context is the reader itself */
+static size_t yabmp_push_read(void* context, void * ptr, size_t size)
+{
+	yabmp* l_reader = (yabmp*)context;
+	size_t l_offset;
+	size_t l_count;
+	
+	assert(l_reader != NULL);
+	assert(l_reader->stream_offset >= l_reader->push_buffer_offset);
+	
+	l_offset = (size_t)(l_reader->stream_offset - l_reader->push_buffer_offset);
+	l_count = l_reader->push_buffer_len - l_offset;
+	if (l_count < size) {
+		/* decoding step will be resumed with more data */
+		l_reader->push_starved = 1;
+	}
+	else {
+		l_count = size;
+	}
+	memcpy(ptr, l_reader->push_buffer + l_offset, l_count);
+	return l_count;
+}
+
+YABMP_API(yabmp_status, yabmp_set_input_push, (yabmp* reader, yabmp_info* info, void* push_context, yabmp_push_info_cb info_fn, yabmp_push_row_cb row_fn))
+{
+	yabmp_status l_status = YABMP_OK;
+	YABMP_CHECK_READER(reader);
+	
+	if ((info == NULL) || (row_fn == NULL)) {
+		yabmp_send_error(reader, "NULL info or NULL row function.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+	/* no seek function, pushed data is read forward */
+	l_status = yabmp_set_input_stream(reader, (void*)reader, yabmp_push_read, NULL, NULL);
+	if (l_status == YABMP_OK) {
+		reader->push_row_fn = row_fn;
+		reader->push_info_fn = info_fn;
+		reader->push_context = push_context;
+		reader->push_info = info;
 	}
 	return l_status;
 }
+
+YABMP_IAPI(yabmp_status, yabmp_stream_push, (yabmp* reader, const yabmp_uint8* data, size_t data_size))
+{
+	size_t l_consumed;
+	
+	assert(reader != NULL);
+	assert(reader->push_row_fn != NULL);
+	
+	/* consumed bytes won't be read again */
+	l_consumed = (size_t)(reader->stream_offset - reader->push_buffer_offset);
+	if (l_consumed > 0U) {
+		memmove(reader->push_buffer, reader->push_buffer + l_consumed, reader->push_buffer_len - l_consumed);
+		reader->push_buffer_len -= l_consumed;
+		reader->push_buffer_offset = reader->stream_offset;
+	}
+	
+	if (data_size > (reader->push_buffer_size - reader->push_buffer_len)) {
+		yabmp_uint8* l_buffer;
+		size_t l_size = reader->push_buffer_size * 2U;
+		
+		if (data_size > ((size_t)-1) - reader->push_buffer_len) {
+			yabmp_send_error(reader, "Would overflow.");
+			return YABMP_ERR_UNKNOW;
+		}
+		if (l_size < (reader->push_buffer_len + data_size)) {
+			l_size = reader->push_buffer_len + data_size;
+		}
+		l_buffer = (yabmp_uint8*)yabmp_malloc(reader, l_size);
+		if (l_buffer == NULL) {
+			return YABMP_ERR_ALLOCATION;
+		}
+		if (reader->push_buffer_len > 0U) {
+			memcpy(l_buffer, reader->push_buffer, reader->push_buffer_len);
+		}
+		yabmp_free(reader, reader->push_buffer);
+		reader->push_buffer = l_buffer;
+		reader->push_buffer_size = l_size;
+	}
+	if (data_size > 0U) {
+		memcpy(reader->push_buffer + reader->push_buffer_len, data, data_size);
+		reader->push_buffer_len += data_size;
+	}
+	return YABMP_OK;
+}
+
+#if defined(YABMP_HAVE_MMAP)
+/* Input mapped file, context is the reader itself */
+static void yabmp_mmap_close(void* context)
+{
+	yabmp* l_reader = (yabmp*)context;
+	
+	assert(l_reader != NULL);
+	assert(l_reader->input_data != NULL);
+	
+	(void)munmap((void*)l_reader->input_data, l_reader->input_data_size);
+	l_reader->input_data = NULL;
+	l_reader->input_data_size = 0U;
+}
+#endif
+
+YABMP_API(yabmp_status, yabmp_set_input_file_mmap, (yabmp* reader, const char* path))
+{
+#if defined(YABMP_HAVE_MMAP)
+	int l_fd;
+	struct stat l_stat;
+	void* l_address = MAP_FAILED;
+	size_t l_size = 0U;
+#endif
+	
+	YABMP_CHECK_READER(reader);
+	
+	if (path == NULL) {
+		yabmp_send_error(reader, "\"path\" is NULL.");
+		return YABMP_ERR_INVALID_ARGS;
+	}
+	
+#if defined(YABMP_HAVE_MMAP)
+	if ((reader->status & YABMP_STATUS_HAS_STREAM) != 0U) {
+		yabmp_send_error(reader, "Stream already set.");
+		return YABMP_ERR_UNKNOW;
+	}
+	
+	l_fd = open(path, O_RDONLY);
+	if (l_fd == -1) {
+		yabmp_send_error(reader, "Can't open file %s for reading.", path);
+		return YABMP_ERR_UNKNOW;
+	}
+	if ((fstat(l_fd, &l_stat) == 0) && (l_stat.st_size > 0)) {
+		l_size = (size_t)l_stat.st_size;
+		if ((off_t)l_size == l_stat.st_size) { /* file might be too big to be mapped */
+			l_address = mmap(NULL, l_size, PROT_READ, MAP_PRIVATE, l_fd, 0);
+		}
+	}
+	(void)close(l_fd); /* mapping stays valid */
+	
+	if (l_address != MAP_FAILED) {
+		yabmp_status l_status;
+		
+		/* memory read & seek functions use stream_offset as their current position */
+		l_status = yabmp_set_input_stream(reader, (void*)reader, yabmp_memory_read, yabmp_memory_seek, yabmp_mmap_close);
+		if (l_status != YABMP_OK) {
+			(void)munmap(l_address, l_size);
+			return l_status;
+		}
+		reader->input_data = (const yabmp_uint8*)l_address;
+		reader->input_data_size = l_size;
+		return YABMP_OK;
+	}
+	/* fall back to stdio */
+#endif
+	return yabmp_set_input_file(reader, path);
+}
+
+YABMP_IAPI(void, yabmp_stream_access_hint, (yabmp* reader, int backward))
+{
+	assert(reader != NULL);
+	
+#if defined(YABMP_HAVE_MMAP)
+	if (reader->close_fn == yabmp_mmap_close) {
+		/* image data will be read once, either forward or backward */
+		(void)madvise((void*)reader->input_data, reader->input_data_size, backward ? MADV_WILLNEED : MADV_SEQUENTIAL);
+	}
+#else
+	(void)reader;
+	(void)backward;
+#endif
+}
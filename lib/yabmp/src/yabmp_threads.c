@@ -0,0 +1,98 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Matthieu DARBOIS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "../inc/private/yabmp_internal.h"
+
+#if defined(YABMP_HAVE_PTHREAD)
+#	include <pthread.h>
+
+typedef struct local_thread_task_struct
+{
+	yabmp_task_cb task_fn;
+	void*         task_context;
+	unsigned int  task_index;
+	int           started;
+	pthread_t     thread;
+} local_thread_task;
+
+static void* local_thread_main(void* context)
+{
+	local_thread_task* l_task = (local_thread_task*)context;
+	
+	assert(l_task != NULL);
+	l_task->task_fn(l_task->task_context, l_task->task_index);
+	return NULL;
+}
+#endif
+
+YABMP_IAPI(void, yabmp_parallel_for, (const yabmp* instance, unsigned int task_count, yabmp_task_cb task_fn, void* task_context))
+{
+	unsigned int i;
+	
+	assert(instance != NULL);
+	assert(task_fn != NULL);
+	
+	if (instance->parallel_fn != NULL) {
+		instance->parallel_fn(instance->parallel_context, task_count, task_fn, task_context);
+		return;
+	}
+	
+#if defined(YABMP_HAVE_PTHREAD)
+	if (task_count > 1U) {
+		local_thread_task* l_tasks = NULL;
+		
+		l_tasks = (local_thread_task*)yabmp_malloc(instance, (task_count - 1U) * sizeof(local_thread_task));
+		if (l_tasks != NULL) {
+			/* task 0 runs on the calling thread */
+			for (i = 1U; i < task_count; ++i) {
+				local_thread_task* l_task = l_tasks + (i - 1U);
+				
+				l_task->task_fn = task_fn;
+				l_task->task_context = task_context;
+				l_task->task_index = i;
+				l_task->started = (pthread_create(&(l_task->thread), NULL, local_thread_main, l_task) == 0);
+			}
+			task_fn(task_context, 0U);
+			for (i = 1U; i < task_count; ++i) {
+				local_thread_task* l_task = l_tasks + (i - 1U);
+				
+				if (l_task->started) {
+					(void)pthread_join(l_task->thread, NULL);
+				} else {
+					/* thread creation failed, run it here */
+					task_fn(task_context, i);
+				}
+			}
+			yabmp_free(instance, l_tasks);
+			return;
+		}
+	}
+#endif
+	
+	/* sequential fallback */
+	for (i = 0U; i < task_count; ++i) {
+		task_fn(task_context, i);
+	}
+}
@@ -57,6 +57,21 @@ static size_t custom_read(void* context, void * ptr, size_t size)
 	(void)size;
 	return 0U;
 }
+static size_t custom_read_at(void* context, yabmp_uint32 offset, void * ptr, size_t size)
+{
+	(void)context;
+	(void)offset;
+	(void)ptr;
+	(void)size;
+	return 0U;
+}
+static yabmp_status custom_push_row(void* context, yabmp_uint32 row_index, const void* row)
+{
+	(void)context;
+	(void)row_index;
+	(void)row;
+	return YABMP_OK;
+}
 static yabmp_status custom_seek(void* context, yabmp_uint32 offset)
 {
 	(void)context;
@@ -121,6 +136,9 @@ int main(int argc, char* argv[])
 		result |= (yabmp_set_input_file(NULL, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
 		result |= (yabmp_set_input_file(l_reader, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
 		result |= (yabmp_set_input_file(l_reader, "dummy/directory/that/does/not/exist/file.txt") == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_file_mmap(NULL, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_file_mmap(l_reader, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_file_mmap(l_reader, "dummy/directory/that/does/not/exist/file.txt") == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
 		
 		result |= (yabmp_set_input_memory(NULL, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
 		result |= (yabmp_set_input_memory(l_reader, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -130,6 +148,156 @@ int main(int argc, char* argv[])
 		
 	}
 	
+	/* test args error for yabmp_reset_reader */
+	{
+		yabmp* l_reader = NULL;
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_reset_reader(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_reset_reader(l_reader) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_stream(l_reader, NULL, custom_read, NULL, custom_close) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_reset_reader(l_reader) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_stream(l_reader, NULL, custom_read, NULL, custom_close) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_set_input_stream_positional */
+	{
+		yabmp* l_reader = NULL;
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_set_input_stream_positional(NULL, NULL, NULL, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_stream_positional(l_reader, NULL, NULL, custom_close) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_stream_positional(l_reader, NULL, custom_read_at, custom_close) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_stream_positional(l_reader, NULL, custom_read_at, NULL) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_set_input_push & yabmp_push_data */
+	{
+		yabmp* l_reader = NULL;
+		yabmp_info* l_info = NULL;
+		static const yabmp_uint8 l_data[2] = { 'B', 'A' };
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_create_info(l_reader, &l_info) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_push_data(NULL, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_push_data(l_reader, NULL, 1U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_push_data(l_reader, l_data, sizeof(l_data)) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_set_input_push(NULL, NULL, NULL, NULL, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_push(l_reader, NULL, NULL, NULL, custom_push_row) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_push(l_reader, l_info, NULL, NULL, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_push(l_reader, l_info, NULL, NULL, custom_push_row) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_push(l_reader, l_info, NULL, NULL, custom_push_row) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_push_data(l_reader, NULL, 0U) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_push_data(l_reader, l_data, 1U) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE; /* not enough data yet */
+		
+		yabmp_destroy_reader(&l_reader, &l_info);
+	}
+	
+	/* test yabmp_probe */
+	{
+		static const yabmp_uint8 l_data[34] = {
+			'B', 'M', 0, 0, 0, 0, 0, 0, 0, 0, 54, 0, 0, 0, /* file header */
+			40, 0, 0, 0, 3, 0, 0, 0, 0xFE, 0xFF, 0xFF, 0xFF, 1, 0, 24, 0, 0, 0, 0, 0 /* 3x2 top-down 24bpp */
+		};
+		yabmp_probe_result l_result;
+		
+		result |= (yabmp_probe(NULL, 0U, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_probe(NULL, 1U, &l_result) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_probe(l_data, sizeof(l_data), NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_probe(l_data + 1, sizeof(l_data) - 1U, &l_result) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_probe(NULL, 0U, &l_result) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (l_result.missing_bytes == 18U) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_probe(l_data, 18U, &l_result) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (l_result.missing_bytes == 16U) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_probe(l_data, sizeof(l_data), &l_result) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= ((l_result.missing_bytes == 0U) && (l_result.width == 3U) && (l_result.height == 2U) && (l_result.bpp == 24U)) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= ((l_result.compression == YABMP_COMPRESSION_NONE) && (l_result.scan_direction == YABMP_SCAN_TOP_DOWN) && (l_result.data_offset == 54U)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	
+	/* test args error for yabmp_get_header_desc */
+	{
+		yabmp* l_reader = NULL;
+		yabmp_info* l_info = NULL;
+		yabmp_header_desc l_desc;
+		struct { yabmp_header_desc desc; yabmp_uint8 appended[16]; } l_newer; /* caller built against a newer yabmp_header_desc */
+		size_t i;
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_create_info(l_reader, &l_info) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		l_desc.struct_size = sizeof(l_desc);
+		result |= (yabmp_get_header_desc(NULL, l_info, &l_desc) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_get_header_desc(l_reader, NULL, &l_desc) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_get_header_desc(l_reader, l_info, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		l_desc.struct_size = sizeof(size_t);
+		result |= (yabmp_get_header_desc(l_reader, l_info, &l_desc) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		/* only the prefix known to the library is filled */
+		memset(&l_newer, 0xA5, sizeof(l_newer));
+		l_newer.desc.struct_size = sizeof(l_newer);
+		result |= (yabmp_get_header_desc(l_reader, l_info, &l_newer.desc) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= ((l_newer.desc.struct_size == sizeof(l_newer)) && (l_newer.desc.palette == NULL) && (l_newer.desc.width == 0U)) ? EXIT_SUCCESS : EXIT_FAILURE;
+		for (i = 0U; i < sizeof(l_newer.appended); ++i) {
+			result |= (l_newer.appended[i] == 0xA5U) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		l_desc.struct_size = sizeof(l_desc);
+		result |= (yabmp_get_header_desc(l_reader, l_info, &l_desc) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= ((l_desc.struct_size == sizeof(l_desc)) && (l_desc.palette == NULL) && (l_desc.icc_profile == NULL)) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, &l_info);
+	}
+	
+	/* test args error for yabmp_create_reader_in_arena & yabmp_query_memory_requirements */
+	{
+		yabmp* l_reader = NULL;
+		yabmp_info* l_info = NULL;
+		yabmp_probe_result l_result;
+		size_t l_size = 0U;
+		void* l_arena = NULL;
+		static double l_small_arena[2];
+		
+		memset(&l_result, 0, sizeof(l_result));
+		l_result.width = 3U;
+		l_result.height = 2U;
+		l_result.bpp = 24U;
+		
+		result |= (yabmp_query_memory_requirements(NULL, 0U, &l_size) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_query_memory_requirements(&l_result, 0U, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_query_memory_requirements(&l_result, YABMP_MEMORY_ROW_INDEX, &l_size) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (l_size > 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_create_reader_in_arena(NULL, NULL, print_error, print_warning, l_small_arena, sizeof(l_small_arena)) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_create_reader_in_arena(&l_reader, NULL, print_error, print_warning, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_create_reader_in_arena(&l_reader, NULL, print_error, print_warning, l_small_arena, sizeof(l_small_arena)) == YABMP_ERR_ALLOCATION) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		l_arena = malloc(l_size);
+		if (l_arena != NULL) {
+			result |= (yabmp_create_reader_in_arena(&l_reader, NULL, print_error, print_warning, l_arena, l_size) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+			result |= (yabmp_create_info(l_reader, &l_info) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+			yabmp_destroy_reader(&l_reader, &l_info);
+			free(l_arena);
+		}
+	}
+	
+	/* test args error for yabmp_set_read_buffer_size */
+	{
+		yabmp* l_reader = NULL;
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_set_read_buffer_size(NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_read_buffer_size(l_reader, 4096U) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_read_buffer_size(l_reader, 16U) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_input_stream(l_reader, NULL, custom_read, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_read_buffer_size(l_reader, 0U) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
 	/* test args error for yabmp_read_info */
 	{
 		yabmp* l_reader = NULL;
@@ -273,6 +441,108 @@ int main(int argc, char* argv[])
 		yabmp_destroy_reader(&l_reader, NULL);
 	}
 	
+	/* test args error for yabmp_read_rows */
+	{
+		yabmp* l_reader = NULL;
+		void* l_rows = (void*)1U;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_read_rows(NULL, l_rows, 0U, 1U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_rows(l_reader, NULL, 0U, 1U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_rows(l_reader, l_rows, 0U, 1U) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_read_row_at */
+	{
+		yabmp* l_reader = NULL;
+		void* l_row = (void*)1U;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_read_row_at(NULL, 0U, l_row, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_row_at(l_reader, 0U, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_row_at(l_reader, 0U, l_row, 0U) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for row index */
+	{
+		yabmp* l_reader = NULL;
+		const yabmp_uint32* l_index = NULL;
+		size_t l_index_len = 0U;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_build_row_index(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_build_row_index(l_reader) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_get_row_index(NULL, &l_index, &l_index_len) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_get_row_index(l_reader, NULL, &l_index_len) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_get_row_index(l_reader, &l_index, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_get_row_index(l_reader, &l_index, &l_index_len) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_index(NULL, l_index, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_index(l_reader, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_index(l_reader, (const yabmp_uint32*)1U, 0U) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_read_image */
+	{
+		yabmp* l_reader = NULL;
+		void* l_image = (void*)1U;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_read_image(NULL, l_image, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_image(l_reader, NULL, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_image(l_reader, l_image, 0U) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_set_read_region */
+	{
+		yabmp* l_reader = NULL;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_set_read_region(NULL, 0U, 0U, 1U, 1U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_read_region(l_reader, 0U, 0U, 1U, 1U) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_set_decode_threads */
+	{
+		yabmp* l_reader = NULL;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_set_decode_threads(NULL, 4U, NULL, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_decode_threads(l_reader, 4U, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
+	/* test args error for yabmp_read_row_ref */
+	{
+		yabmp* l_reader = NULL;
+		const void* l_row = NULL;
+		
+		result |= (yabmp_create_reader(&l_reader, NULL, print_error, print_warning, NULL, NULL, NULL) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		result |= (yabmp_read_row_ref(NULL, &l_row) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_row_ref(l_reader, NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_read_row_ref(l_reader, &l_row) == YABMP_ERR_UNKNOW) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (l_row == NULL) ? EXIT_SUCCESS : EXIT_FAILURE;
+		
+		yabmp_destroy_reader(&l_reader, NULL);
+	}
+	
 	/* test args error for yabmp_set_* transforms */
 	{
 		yabmp* l_reader = NULL;
@@ -287,7 +557,20 @@ int main(int argc, char* argv[])
 		
 		result |= (yabmp_set_invert_scan_direction(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
 		result |= (yabmp_set_expand_to_bgrx(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_expand_to_bgra(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
 		result |= (yabmp_set_expand_to_grayscale(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_rgb_to_gray(NULL, YABMP_LUMA_BT601) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_rgb_to_gray(l_reader, 2U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_scale_to_full_range(NULL) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_scale_to_full_range(l_reader) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_output_format(NULL, YABMP_OUTPUT_RGB) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_output_format(l_reader, 8U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_output_format(l_reader, YABMP_OUTPUT_RGB | YABMP_OUTPUT_ALPHA_FIRST | YABMP_OUTPUT_BIG_ENDIAN) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_alignment(NULL, 16U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_alignment(l_reader, 0U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_alignment(l_reader, 48U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_alignment(l_reader, 512U) == YABMP_ERR_INVALID_ARGS) ? EXIT_SUCCESS : EXIT_FAILURE;
+		result |= (yabmp_set_row_alignment(l_reader, 64U) == YABMP_OK) ? EXIT_SUCCESS : EXIT_FAILURE;
 		
 		yabmp_destroy_reader(&l_reader, NULL);
 	}